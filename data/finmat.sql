@@ -33,6 +33,37 @@ CREATE TABLE IF NOT EXISTS dcm_def
     description VARCHAR(100)
 );
 
+###!cal_def - table holding holiday calendar definitions
+CREATE TABLE IF NOT EXISTS cal_def
+(
+    cal_nm VARCHAR(20) NOT NULL PRIMARY KEY,
+    weekends INT NOT NULL DEFAULT 1 CHECK (weekends IN (0, 1)),
+    year_first INT NOT NULL DEFAULT 1901,
+    year_last INT NOT NULL DEFAULT 2199
+);
+
+###!cal_data - table holding holidays of holiday calendars
+CREATE TABLE IF NOT EXISTS cal_data
+(
+    cal_nm VARCHAR(20) NOT NULL,
+    holiday INT NOT NULL,
+    FOREIGN KEY (cal_nm) REFERENCES cal_def(cal_nm),
+    UNIQUE (cal_nm, holiday)
+);
+
+###!load_all_cal_data - load all holiday calendars
+SELECT
+     cal.cal_nm
+    ,cal.weekends
+    ,cal.year_first
+    ,cal.year_last
+    ,hol.holiday 
+FROM
+    cal_def AS cal
+    LEFT JOIN cal_data AS hol ON cal.cal_nm = hol.cal_nm 
+ORDER BY
+    cal.cal_nm, hol.holiday;
+
 ###!crv_def - table holding curve definitions
 CREATE TABLE IF NOT EXISTS crv_def
 (
@@ -42,6 +73,7 @@ CREATE TABLE IF NOT EXISTS crv_def
     crv_type VARCHAR(10) NOT NULL,
     underlying1 VARCHAR(20),
     underlying2 VARCHAR(20),
+    interp VARCHAR(20),
     FOREIGN KEY (ccy_nm) REFERENCES ccy_def(ccy_nm),
     FOREIGN KEY (dcm) REFERENCES fx_def(dcm),
     UNIQUE (crv_nm, ccy_nm)
@@ -59,7 +91,7 @@ CREATE TABLE IF NOT EXISTS crv_data
 );
 
 ###!load_all_crv_nms - load list of all curve names
-SELECT crv_nm FROM crv_def;
+SELECT crv_nm FROM crv_def ORDER BY CASE WHEN crv_type = 'base' THEN 0 ELSE 1 END, crv_nm;
 
 ###!load_crv_def - load curve definitions
 SELECT
@@ -69,6 +101,7 @@ SELECT
     ,crv1.crv_type
     ,crv1.underlying1
     ,crv1.underlying2 
+    ,COALESCE(crv1.interp, crv2.interp, 'linear') AS interp 
 FROM
     crv_def AS crv1
     LEFT JOIN crv_def AS crv2 ON crv1.underlying1 = crv2.crv_nm 
@@ -76,19 +109,13 @@ WHERE
     crv1.crv_nm = ##crv_nm##;
 
 ###!load_base_crv_data - load curve data for a base curve
-SELECT scn_no, tenor, rate FROM crv_data WHERE crv_nm = ##crv_nm##;
+SELECT scn_no, tenor, rate FROM crv_data WHERE crv_nm = ##crv_nm## ORDER BY scn_no, tenor;
 
-###!load_compound_crv_data - load curve data for a compound curve
-SELECT
-    crv1.scn_no,
-    crv1.tenor,
-    crv1.rate + crv2.rate AS rate 
-FROM
-    crv_data AS crv1
-    INNER JOIN crv_data AS crv2 ON crv1.scn_no = crv2.scn_no AND crv1.tenor = crv2.tenor 
-WHERE
-    crv1.crv_nm = ##crv_nm1##
-    AND crv2.crv_nm = ##crv_nm2##;
+###!load_all_crv_def - load all curve definitions
+SELECT crv_nm, ccy_nm, dcm, crv_type, underlying1, underlying2, interp FROM crv_def ORDER BY crv_nm;
+
+###!load_all_crv_data - load all curve data
+SELECT crv_nm, scn_no, tenor, rate FROM crv_data ORDER BY crv_nm, scn_no, tenor;
 
 ###!vol_surf_def - table with volatility surface definitions
 CREATE TABLE IF NOT EXISTS vol_surf_def
@@ -96,7 +123,7 @@ CREATE TABLE IF NOT EXISTS vol_surf_def
     vol_surf_nm VARCHAR(20) NOT NULL PRIMARY KEY,
     ccy_nm CHAR(3) NOT NULL REFERENCES ccy_data(ccy_nm),
     underlying VARCHAR(20) NOT NULL,
-    vol_surf_type VARCHAR(20) NOT NULL CHECK (vol_surf_type = "cap" OR vol_surf_type = "floor" OR vol_surf_type = "swaption" OR vol_surf_type = "equity"),
+    vol_surf_type VARCHAR(20) NOT NULL CHECK (vol_surf_type = "cap" OR vol_surf_type = "floor" OR vol_surf_type = "swaption" OR vol_surf_type = "swaption_cube" OR vol_surf_type = "sabr" OR vol_surf_type = "equity"),
     comments VARCHAR(100)
 );
 
@@ -112,6 +139,34 @@ CREATE TABLE IF NOT EXISTS vol_surf_data
     UNIQUE (vol_surf_nm, scn_no, tenor, strike)
 );
 
+###!vol_cube_data - table with swaption volatility cubes; tenor is option expiry and swap_tenor is length of underlying swap, both in days
+CREATE TABLE IF NOT EXISTS vol_cube_data
+(
+    vol_surf_nm CHAR(3) NOT NULL,
+    scn_no INT NOT NULL CHECK (scn_no > 0),
+    tenor FLOAT NOT NULL CHECK (tenor >= 0),
+    swap_tenor FLOAT NOT NULL CHECK (swap_tenor > 0),
+    strike FLOAT NOT NULL,
+    volatility FLOAT NOT NULL CHECK (volatility > 0),
+    FOREIGN KEY (vol_surf_nm) REFERENCES vol_surf_def(vol_surf_nm),
+    UNIQUE (vol_surf_nm, scn_no, tenor, swap_tenor, strike)
+);
+
+###!vol_sabr_data - table with SABR parameters of volatility surfaces; tenor is option expiry in days and shift is applied to forward rates and strikes
+CREATE TABLE IF NOT EXISTS vol_sabr_data
+(
+    vol_surf_nm CHAR(3) NOT NULL,
+    scn_no INT NOT NULL CHECK (scn_no > 0),
+    tenor FLOAT NOT NULL CHECK (tenor >= 0),
+    alpha FLOAT NOT NULL CHECK (alpha > 0),
+    beta FLOAT NOT NULL CHECK (beta >= 0 AND beta <= 1),
+    rho FLOAT NOT NULL CHECK (rho > -1 AND rho < 1),
+    nu FLOAT NOT NULL CHECK (nu >= 0),
+    shift FLOAT NOT NULL DEFAULT 0,
+    FOREIGN KEY (vol_surf_nm) REFERENCES vol_surf_def(vol_surf_nm),
+    UNIQUE (vol_surf_nm, scn_no, tenor)
+);
+
 ###!load_all_vol_surf_nms - load list of all volatility surfaces
 SELECT vol_surf_nm FROM vol_surf_def;
 
@@ -120,6 +175,12 @@ SELECT vol_surf_nm, ccy_nm, vol_surf_type, underlying FROM vol_surf_def WHERE vo
 
 ###!load_vol_surf_data - load volatity surface data
 SELECT scn_no, tenor, strike, volatility FROM vol_surf_data WHERE vol_surf_nm = ##vol_surf_nm##;
+
+###!load_vol_cube_data - load volatity cube data
+SELECT scn_no, tenor, swap_tenor, strike, volatility FROM vol_cube_data WHERE vol_surf_nm = ##vol_surf_nm##;
+
+###!load_vol_sabr_data - load SABR parameters of volatility surface
+SELECT scn_no, tenor, alpha, beta, rho, nu, shift FROM vol_sabr_data WHERE vol_surf_nm = ##vol_surf_nm##;
     
 ###!freq_def - table holding frequency definitions
 CREATE TABLE IF NOT EXISTS freq_def
@@ -159,6 +220,8 @@ CREATE TABLE IF NOT EXISTS bnd_data
     amort FLOAT,
     crv_disc VARCHAR(20) NOT NULL,
     crv_fwd VARCHAR(20),
+    cal_nm VARCHAR(50),
+    bday_conv VARCHAR(20) CHECK (bday_conv IN ('unadjusted', 'following', 'modified_following', 'preceding', 'modified_preceding')),
     FOREIGN KEY (ccy_nm) REFERENCES ccy_def(ccy_nm),
     FOREIGN KEY (dcm) REFERENCES dcm_def(dcm),
     FOREIGN KEY (cpn_freq) REFERENCES freq_def(freq),
@@ -212,6 +275,8 @@ CREATE TABLE IF NOT EXISTS ann_data
     rate_add FLOAT,
     crv_disc VARCHAR(20) NOT NULL,
     crv_fwd VARCHAR(20),
+    cal_nm VARCHAR(50),
+    bday_conv VARCHAR(20) CHECK (bday_conv IN ('unadjusted', 'following', 'modified_following', 'preceding', 'modified_preceding')),
     FOREIGN KEY (ccy_nm) REFERENCES ccy_def(ccy_nm),
     FOREIGN KEY (ann_freq) REFERENCES freq_def(freq),
     FOREIGN KEY (fix_freq) REFERENCES freq_def(freq),
@@ -269,6 +334,8 @@ CREATE TABLE IF NOT EXISTS cap_floor_data
     amort FLOAT,
     crv_disc VARCHAR(20) NOT NULL,
     crv_fwd VARCHAR(20),
+    cal_nm VARCHAR(50),
+    bday_conv VARCHAR(20) CHECK (bday_conv IN ('unadjusted', 'following', 'modified_following', 'preceding', 'modified_preceding')),
     FOREIGN KEY (ccy_nm) REFERENCES ccy_def(ccy_nm),
     FOREIGN KEY (dcm) REFERENCES dcm_def(dcm),
     FOREIGN KEY (int_freq) REFERENCES freq_def(freq),
@@ -325,6 +392,8 @@ CREATE TABLE IF NOT EXISTS swaption_data
     amort FLOAT,
     crv_disc VARCHAR(20) NOT NULL,
     crv_fwd VARCHAR(20),
+    cal_nm VARCHAR(50),
+    bday_conv VARCHAR(20) CHECK (bday_conv IN ('unadjusted', 'following', 'modified_following', 'preceding', 'modified_preceding')),
     FOREIGN KEY (ccy_nm) REFERENCES ccy_def(ccy_nm),
     FOREIGN KEY (dcm) REFERENCES dcm_def(dcm),
     FOREIGN KEY (fix_freq) REFERENCES freq_def(freq),
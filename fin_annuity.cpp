@@ -9,6 +9,8 @@
 #include "lib_aux.h"
 #include "lib_date.h"
 #include "lib_dataframe.h"
+#include "lib_math.h"
+#include "lib_solver.h"
 #include "fin_curve.h"
 #include "fin_fx.h"
 #include "fin_date.h"
@@ -22,7 +24,7 @@
 static double calc_ann_payment(const double &rate, const int &rmng_ann_payments, const int &payment_freq)
 {
    double q = 1 / (1 + rate / payment_freq);
-   return 1 / (q * (1 - static_cast<double>(pow(q, rmng_ann_payments)))) * (1 - q);
+   return 1 / (q * (1 - fast_pow(q, rmng_ann_payments))) * (1 - q);
 }
 
 // calculate npv of annuity; this is an auxiliary function used in annuity repricing function
@@ -71,43 +73,22 @@ static double get_ann_rate(const int &rmng_ann_payments, const int &payment_freq
     // calculate forward rate as an initial estimate
     double r;
     if (dt > 1.0)
-        r = static_cast<double>(pow(dfs[0] / dfs[dfs.size() - 1], 1 / dt)) - 1;
+        r = fast_pow(dfs[0] / dfs[dfs.size() - 1], 1 / dt) - 1;
     else
         r = (dfs[0] / dfs[dfs.size() - 1] - 1) / dt;
 
-    // set delta rate to determine numerical derivation
+    // npv as a function of annuity rate and its numerical derivative; derivatives below 1e-10 are treated as zero,
+    // which stops the iteration
     double dr = 0.0001;
-
-    // determine optimal rate through Newton-Raphson method
-    for (int iter_idx = 0; iter_idx < max_iter_no; iter_idx++)
+    auto npv = [&](const double &rate) {return calc_ann_npv_aux(rate, rmng_ann_payments, payment_freq, dfs);};
+    auto d_npv = [&](const double &rate)
     {
-        // calculate auxiliary npv and check if further iteration is needed
-        double npv = calc_ann_npv_aux(r, rmng_ann_payments, payment_freq, dfs);
-        if (abs(npv) < precission)
-        {
-            return r;
-        }
-     
-        // unfortunately, further iteration is needed
-        double npv_down = calc_ann_npv_aux(r - dr, rmng_ann_payments, payment_freq, dfs);
-        double npv_up = calc_ann_npv_aux(r + dr, rmng_ann_payments, payment_freq, dfs);
-
-        // calculate numerical derivative
-        double d_npv = (npv_up - npv_down) / (2 * dr);
-
-        // calculate annuity rate correction if needed
-        if (abs(d_npv) > 1e-10)
-        {
-            r -= npv / d_npv;
-        }
-        else
-        {
-            return r;
-        }
-    }
+        double d = (npv(rate + dr) - npv(rate - dr)) / (2 * dr);
+        return (std::fabs(d) > 1e-10) ? d : 0.0;
+    };
 
-    // return repricing annuity rate
-    return r;
+    // determine optimal rate through Newton-Raphson method
+    return newton(npv, d_npv, r, precission, max_iter_no).x;
 }
 
 // extract vector of dates from vector of events
@@ -144,7 +125,7 @@ static std::vector<myDate> extract_dates_from_events(const std::vector<ann_event
  * OBJECT CONSTRUCTORS
  */
 
-myAnnuities::myAnnuities(const mySQLite &db, const std::string &sql, const myDate &calc_date)
+myAnnuities::myAnnuities(const mySQLite &db, const std::string &sql, const myDate &calc_date, const myCalendars * cals)
 {
     // dataframe to hold result of SQL query
     myDataFrame * rslt = new myDataFrame();
@@ -155,7 +136,8 @@ myAnnuities::myAnnuities(const mySQLite &db, const std::string &sql, const myDat
     // auxiliary variables
     std::string aux;
     myDate date_aux;
-    std::vector<myDate> event_dates;
+    date_serie_ptr event_dates;
+    date_serie_ptr adj_event_dates;
     std::vector<myDate> begin_ann_dates;
     std::vector<myDate> end_ann_dates;
 
@@ -393,6 +375,13 @@ myAnnuities::myAnnuities(const mySQLite &db, const std::string &sql, const myDat
                 }
             }
 
+            // holiday calendar and business day convention; the columns are missing in tables created before they
+            // were introduced
+            std::string cal_nm = (rslt->tbl.values[ann_idx].size() > 25) ? rslt->tbl.values[ann_idx][25] : "";
+            std::string conv_nm = (rslt->tbl.values[ann_idx].size() > 26) ? rslt->tbl.values[ann_idx][26] : "";
+            const myCalendar * cal = get_schedule_cal(cals, cal_nm, conv_nm, ann.conv, ann.wrn_msg);
+            ann.cal_nm = (cal != nullptr) ? cal_nm : "";
+
         // perform other sanity checks
        
             // value date
@@ -454,6 +443,14 @@ myAnnuities::myAnnuities(const mySQLite &db, const std::string &sql, const myDat
                 }
             }
 
+        // parse frequencies into tenors; events are generated without any further string manipulation
+
+            ann.ann_tenor = parse_tenor(ann.ann_freq);
+            if (ann.fix_freq.compare("") != 0)
+            {
+                ann.fix_tenor = parse_tenor(ann.fix_freq);
+            }
+
         // generate vector of events
 
             // variables containing dates
@@ -466,34 +463,38 @@ myAnnuities::myAnnuities(const mySQLite &db, const std::string &sql, const myDat
 
             // position index
             int pos_idx;
-
-            // date format, which is used to store date string in object myDate
-            std::string date_format = "yyyymmdd";
+            std::vector<int> pos_idxs;
 
             // iterate until you find the first annuity period that does not preceed calculation date
             date1 = ann.first_ann_date;
             date2 = ann.first_ann_date;
-            date2.remove(ann.ann_freq);
+            date2.remove(ann.ann_tenor);
             while ((date1.get_days_no() < calc_date.get_days_no()) & (date2.get_days_no() < calc_date.get_days_no()))
             {
                 date1 = date2;
-                date2.add(ann.ann_freq);
+                date2.add(ann.ann_tenor);
             }
             
             // date1 represents the beginning date of such annuity period => we generate annuity dates till maturity
-            event_dates = create_date_serie(date1.get_date_str(), ann.maturity_date.get_date_str(), ann.ann_freq, date_format);     
+            event_dates = get_date_serie(date1, ann.maturity_date, ann.ann_tenor);
+            adj_event_dates = (cal != nullptr) ? get_date_serie(date1, ann.maturity_date, ann.ann_tenor, *cal, ann.conv) : event_dates;
 
-            // create a vector of events based on annuity dates
-            for (int idx = 0; idx < event_dates.size(); idx++)
+            // create a vector of events based on annuity dates; annuity periods are rolled on unadjusted dates and
+            // both of their ends are adjusted to business days
+            for (int idx = 0; idx < event_dates->size(); idx++)
             {
-                date1 = event_dates[idx];
-                date2 = date1;
-                date1.remove(ann.ann_freq);
+                date1 = (*event_dates)[idx];
+                date1.remove(ann.ann_tenor);
+                date2 = (*adj_event_dates)[idx];
+                if (cal != nullptr)
+                {
+                    date1 = cal->adjust(date1, ann.conv);
+                }
                 evnt.date_begin = date1; // beging of annuity period
                 evnt.date_end = date2; // end of annuity period => date of annuity payment
 
                 // number of remaining annuity payments
-                evnt.rmng_ann_payments = event_dates.size() - idx;
+                evnt.rmng_ann_payments = event_dates->size() - idx;
 
                 // indicated that annuity payment is fixed and therefore
                 // could be calculated without a scenario knowledge
@@ -530,19 +531,24 @@ myAnnuities::myAnnuities(const mySQLite &db, const std::string &sql, const myDat
                 date1 = ann.first_fix_date;
                 while (date1.get_days_no() < calc_date.get_days_no())
                 {
-                    date1.add(ann.fix_freq);
+                    date1.add(ann.fix_tenor);
                 }
 
                 // date1 is the first repricing date => we generate repricing dates till maturity
-                event_dates = create_date_serie(date1.get_date_str(), ann.maturity_date.get_date_str(), ann.fix_freq, date_format);
+                event_dates = get_date_serie(date1, ann.maturity_date, ann.fix_tenor);
+                adj_event_dates = (cal != nullptr) ? get_date_serie(date1, ann.maturity_date, ann.fix_tenor, *cal, ann.conv) : event_dates;
+
+                // match adjusted repricing dates with the nearest annuity period begin dates in a single merge pass
+                pos_idxs.resize(event_dates->size());
+                match_dates(*adj_event_dates, begin_ann_dates, date_match::nearest, pos_idxs.data());
 
                 // determine in which coupon periods there will be repricing
-                for (int idx = 0; idx < event_dates.size(); idx++)
+                for (int idx = 0; idx < event_dates->size(); idx++)
                 {
                     // we assign repricing flag based on begining coupon date
-                    if (event_dates[idx].get_date_int() < ann.maturity_date.get_date_int())
+                    if ((*event_dates)[idx].get_date_int() < ann.maturity_date.get_date_int())
                     {
-                        pos_idx = get_nearest_idx(event_dates[idx], begin_ann_dates, "abs");
+                        pos_idx = pos_idxs[idx];
                         events[pos_idx].fix_flg = true;
                     }
                 }
@@ -564,8 +570,12 @@ myAnnuities::myAnnuities(const mySQLite &db, const std::string &sql, const myDat
                         {
                             date1 = events[idx].date_begin;
                             date2 = date1;
-                            date2.add(ann.fix_freq);
-                      
+                            date2.add(ann.fix_tenor);
+                            if (cal != nullptr)
+                            {
+                                date2 = cal->adjust(date2, ann.conv);
+                            }
+
                             // all annuities are repriced with a par-rate; their
                             // amortization pattern depends on the annuity rate,
                             // so we can only collect date information
@@ -627,7 +637,7 @@ myAnnuities::myAnnuities(const mySQLite &db, const std::string &sql, const myDat
                         if (events[idx].date_begin.get_days_no() <= calc_date.get_days_no())
                         {
                             // year fraction for the first coupon payment; we assume actual / 365 day count method
-                            double acc_int_year_frac = day_count_method(events[idx].date_begin, calc_date, "ACT_365");
+                            double acc_int_year_frac = day_count_method(events[idx].date_begin, calc_date, dcm_method::act_365);
                             ann.ext_acc_int = events[idx].ext_rate * events[idx].nominal_begin * acc_int_year_frac;
                         }
                         // in case of a forward contract accrued interest is zero
@@ -781,6 +791,10 @@ void myAnnuities::calc_npv(const int &scn_no, const myCurves &crvs, const myFx &
     // go annuity by annuity
     for (int ann_idx = 0; ann_idx < this->info.size(); ann_idx++)
     {
+        // resolve curve handles so that curves are not looked up by name event by event
+        this->info[ann_idx].crv_disc_idx = crvs.get_crv_idx(this->info[ann_idx].crv_disc);
+        this->info[ann_idx].crv_fwd_idx = (this->info[ann_idx].crv_fwd.size() > 0) ? crvs.get_crv_idx(this->info[ann_idx].crv_fwd) : -1;
+
         // calculate repricing rates for floating annuities
         if (!this->info[ann_idx].is_fixed)
         {
@@ -819,7 +833,7 @@ void myAnnuities::calc_npv(const int &scn_no, const myCurves &crvs, const myFx &
                     }
 
                     // extract vector of discounting factors
-                    std::vector<double> dfs = crvs.get_df(this->info[ann_idx].crv_fwd, scn_tenors);
+                    std::vector<double> dfs = crvs.get_df(this->info[ann_idx].crv_fwd_idx, scn_tenors);
 
                     // estimate repricing annuity rate through Newton-Raphson method
                     int max_iter_no = 5;
@@ -854,7 +868,7 @@ void myAnnuities::calc_npv(const int &scn_no, const myCurves &crvs, const myFx &
             scn_tenors.push_back(std::tuple<int, int>(scn_no, this->info[ann_idx].events[idx].date_end.get_date_int()));
             
             // get discounting factor
-            std::vector<double> dfs = crvs.get_df(this->info[ann_idx].crv_disc, scn_tenors);
+            std::vector<double> dfs = crvs.get_df(this->info[ann_idx].crv_disc_idx, scn_tenors);
 
             // store discount factor
             this->info[ann_idx].events[idx].df = dfs[0];
@@ -197,6 +197,7 @@ int main()
 #include <vector>
 #include <thread>
 #include "lib_date.h"
+#include "fin_date.h"
 #include "fin_curve.h"
 #include "fin_fx.h"
 
@@ -249,11 +250,17 @@ struct ann_info
     double rate_add = 0.0;
     myDate first_ann_date;
 	std::string ann_freq;
+    tenor_def ann_tenor; // tenor parsed from ann_freq once per contract
 	double ann_freq_aux = 0.0;
     myDate first_fix_date;
 	std::string fix_freq;
+    tenor_def fix_tenor; // tenor parsed from fix_freq once per contract
 	std::string crv_disc;
 	std::string crv_fwd;
+    std::string cal_nm; // holiday calendar of annuity and repricing dates
+    bday_conv conv = bday_conv::unadjusted; // business day convention applied to the dates
+    int crv_disc_idx = -1; // curve handles resolved when NPV is calculated
+    int crv_fwd_idx = -1;
     double int_npv = 0.0;
     double int_npv_ref_ccy = 0.0;
     double ext_npv = 0.0;
@@ -275,7 +282,7 @@ class myAnnuities
     public:
         // object constructors
         myAnnuities(std::vector<ann_info> info){this->info = info;};
-        myAnnuities(const mySQLite &db, const std::string &sql, const myDate &calc_date);
+        myAnnuities(const mySQLite &db, const std::string &sql, const myDate &calc_date, const myCalendars * cals = nullptr);
 
         // copy constructor
         myAnnuities(const myAnnuities &anns){this->info = anns.info;};
@@ -50,7 +50,7 @@ static std::vector<myDate> extract_dates_from_events(const std::vector<bnd_event
  * OBJECT CONSTRUCTORS
  */
 
-myBonds::myBonds(const mySQLite &db, const std::string &sql, const myDate &calc_date)
+myBonds::myBonds(const mySQLite &db, const std::string &sql, const myDate &calc_date, const myCalendars * cals)
 {
     // dataframe to hold result of SQL query
     myDataFrame * rslt = new myDataFrame();
@@ -61,7 +61,8 @@ myBonds::myBonds(const mySQLite &db, const std::string &sql, const myDate &calc_
     // auxiliary variables
     std::string aux;
     myDate date_aux;
-    std::vector<myDate> event_dates;
+    date_serie_ptr event_dates;
+    date_serie_ptr adj_event_dates;
     std::vector<myDate> begin_cpn_dates;
     std::vector<myDate> end_cpn_dates;
 
@@ -137,6 +138,7 @@ myBonds::myBonds(const mySQLite &db, const std::string &sql, const myDate &calc_
 
             // day count method used to calculate coupon payment
             bnd.dcm = rslt->tbl.values[bnd_idx][15];
+            bnd.dcm_type = get_dcm_method(bnd.dcm);
 
             // bond accrued interest
             aux = rslt->tbl.values[bnd_idx][16];
@@ -397,6 +399,13 @@ myBonds::myBonds(const mySQLite &db, const std::string &sql, const myDate &calc_
                 }
             }
 
+            // holiday calendar and business day convention; the columns are missing in tables created before they
+            // were introduced
+            std::string cal_nm = (rslt->tbl.values[bnd_idx].size() > 29) ? rslt->tbl.values[bnd_idx][29] : "";
+            std::string conv_nm = (rslt->tbl.values[bnd_idx].size() > 30) ? rslt->tbl.values[bnd_idx][30] : "";
+            const myCalendar * cal = get_schedule_cal(cals, cal_nm, conv_nm, bnd.conv, bnd.wrn_msg);
+            bnd.cal_nm = (cal != nullptr) ? cal_nm : "";
+
         // perform other sanity checks
        
             // value date
@@ -490,6 +499,21 @@ myBonds::myBonds(const mySQLite &db, const std::string &sql, const myDate &calc_
                 }
             }
 
+        // parse frequencies into tenors; events are generated without any further string manipulation
+
+            if (bnd.cpn_freq.compare("") != 0)
+            {
+                bnd.cpn_tenor = parse_tenor(bnd.cpn_freq);
+            }
+            if (bnd.amort_freq.compare("") != 0)
+            {
+                bnd.amort_tenor = parse_tenor(bnd.amort_freq);
+            }
+            if (bnd.fix_freq.compare("") != 0)
+            {
+                bnd.fix_tenor = parse_tenor(bnd.fix_freq);
+            }
+
         // generate vector of events
 
             // variables containing dates
@@ -502,9 +526,7 @@ myBonds::myBonds(const mySQLite &db, const std::string &sql, const myDate &calc_
 
             // position index
             int pos_idx;
-
-            // date format, which is used to store date string in object myDate
-            std::string date_format = "yyyymmdd";
+            std::vector<int> pos_idxs;
 
             // find date of the first copoun payment and a create vector coupon events;
             // we assume that all other events occur on coupon payment dates
@@ -513,25 +535,31 @@ myBonds::myBonds(const mySQLite &db, const std::string &sql, const myDate &calc_
                 // iterate until you find the first coupon period that does not preceed calculation date
                 date1 = bnd.first_cpn_date;
                 date2 = bnd.first_cpn_date;
-                date2.remove(bnd.cpn_freq);
+                date2.remove(bnd.cpn_tenor);
                 while ((date1.get_days_no() < calc_date.get_days_no()) & (date2.get_days_no() < calc_date.get_days_no()))
                 {
                     date1 = date2;
-                    date2.add(bnd.cpn_freq);
+                    date2.add(bnd.cpn_tenor);
                 }
                 
                 // date1 represents the beginning date of such coupon period => we generate coupon dates till maturity
-                event_dates = create_date_serie(date1.get_date_str(), bnd.maturity_date.get_date_str(), bnd.cpn_freq, date_format);     
+                event_dates = get_date_serie(date1, bnd.maturity_date, bnd.cpn_tenor);
+                adj_event_dates = (cal != nullptr) ? get_date_serie(date1, bnd.maturity_date, bnd.cpn_tenor, *cal, bnd.conv) : event_dates;
 
-                // create a vector of events based on coupon dates
-                for (int idx = 0; idx < event_dates.size(); idx++)
+                // create a vector of events based on coupon dates; coupon periods are rolled on unadjusted dates
+                // and both of their ends are adjusted to business days
+                for (int idx = 0; idx < event_dates->size(); idx++)
                 {
-                    date1 = event_dates[idx];
-                    date2 = date1;
-                    date1.remove(bnd.cpn_freq);
+                    date1 = (*event_dates)[idx];
+                    date1.remove(bnd.cpn_tenor);
+                    date2 = (*adj_event_dates)[idx];
+                    if (cal != nullptr)
+                    {
+                        date1 = cal->adjust(date1, bnd.conv);
+                    }
                     evnt.date_begin = date1; // beging of coupon period
                     evnt.date_end = date2; // end of coupon period => date of coupon payment
-                    evnt.cpn_year_frac = day_count_method(date1, date2, bnd.dcm);
+                    evnt.cpn_year_frac = day_count_method(date1, date2, bnd.dcm_type);
                     evnt.is_cpn_payment = true;
 
                     // indicate that coupon payment is fixed and therefore
@@ -579,19 +607,24 @@ myBonds::myBonds(const mySQLite &db, const std::string &sql, const myDate &calc_
                 date1 = bnd.first_amort_date;
                 while (date1.get_days_no() < calc_date.get_days_no())
                 {
-                    date1.add(bnd.amort_freq);
+                    date1.add(bnd.amort_tenor);
                 }
 
                 // date1 is the first amortization date => we generate amortizaton dates till maturity
-                event_dates = create_date_serie(date1.get_date_str(), bnd.maturity_date.get_date_str(), bnd.amort_freq, date_format);
+                event_dates = get_date_serie(date1, bnd.maturity_date, bnd.amort_tenor);
+                adj_event_dates = (cal != nullptr) ? get_date_serie(date1, bnd.maturity_date, bnd.amort_tenor, *cal, bnd.conv) : event_dates;
+
+                // match adjusted amortization dates with the nearest coupon end dates in a single merge pass
+                pos_idxs.resize(event_dates->size());
+                match_dates(*adj_event_dates, end_cpn_dates, date_match::nearest, pos_idxs.data());
 
                 // go amortization date by amortization date and assign it the nearest coupon date; we assume that amortizations happen on coupon dates
-                for (int idx = 0; idx < event_dates.size(); idx++)
+                for (int idx = 0; idx < event_dates->size(); idx++)
                 {
                     // we assign amortization flag based on begining coupon date
-                    if (event_dates[idx].get_date_int() < bnd.maturity_date.get_date_int())
+                    if ((*event_dates)[idx].get_date_int() < bnd.maturity_date.get_date_int())
                     {
-                        pos_idx = get_nearest_idx(event_dates[idx], end_cpn_dates, "abs");
+                        pos_idx = pos_idxs[idx];
                         events[pos_idx].amort_flg = true;
                     }
                 }
@@ -638,19 +671,24 @@ myBonds::myBonds(const mySQLite &db, const std::string &sql, const myDate &calc_
                 date1 = bnd.first_fix_date;
                 while (date1.get_days_no() < calc_date.get_days_no())
                 {
-                    date1.add(bnd.fix_freq);
+                    date1.add(bnd.fix_tenor);
                 }
 
                 // date1 is the first repricing date => we generate repricing dates till maturity
-                event_dates = create_date_serie(date1.get_date_str(), bnd.maturity_date.get_date_str(), bnd.fix_freq, date_format);
+                event_dates = get_date_serie(date1, bnd.maturity_date, bnd.fix_tenor);
+                adj_event_dates = (cal != nullptr) ? get_date_serie(date1, bnd.maturity_date, bnd.fix_tenor, *cal, bnd.conv) : event_dates;
+
+                // match adjusted repricing dates with the nearest coupon begin dates in a single merge pass
+                pos_idxs.resize(event_dates->size());
+                match_dates(*adj_event_dates, begin_cpn_dates, date_match::nearest, pos_idxs.data());
 
                 // determine in which coupon periods there will be repricing
-                for (int idx = 0; idx < event_dates.size(); idx++)
+                for (int idx = 0; idx < event_dates->size(); idx++)
                 {
                     // we assign repricing flag based on begining coupon date
-                    if (event_dates[idx].get_date_int() < bnd.maturity_date.get_date_int())
+                    if ((*event_dates)[idx].get_date_int() < bnd.maturity_date.get_date_int())
                     {
-                        pos_idx = get_nearest_idx(event_dates[idx], begin_cpn_dates, "abs");
+                        pos_idx = pos_idxs[idx];
                         events[pos_idx].fix_flg = true;
                     }
                 }
@@ -671,8 +709,12 @@ myBonds::myBonds(const mySQLite &db, const std::string &sql, const myDate &calc_
                         {
                             date1 = events[idx].date_begin;
                             date2 = date1;
-                            date2.add(bnd.fix_freq);
-                       
+                            date2.add(bnd.fix_tenor);
+                            if (cal != nullptr)
+                            {
+                                date2 = cal->adjust(date2, bnd.conv);
+                            }
+
                             // forward rate repricing - only the boundary dates
                             if (bnd.fix_type.compare("fwd") == 0)
                             {
@@ -714,7 +756,7 @@ myBonds::myBonds(const mySQLite &db, const std::string &sql, const myDate &calc_
                         if (events[idx].date_begin.get_days_no() <= calc_date.get_days_no())
                         {
                             // year fraction for the first coupon payment
-                            double acc_int_year_frac = day_count_method(events[idx].date_begin, calc_date, bnd.dcm);
+                            double acc_int_year_frac = day_count_method(events[idx].date_begin, calc_date, bnd.dcm_type);
                             bnd.acc_int = bnd.cpn_rate * events[idx].nominal_begin * acc_int_year_frac;
                         }
                         // in case of a forward contract accrued interest is zero
@@ -870,6 +912,10 @@ void myBonds::calc_npv(const int &scn_no, const myCurves &crvs, const myFx &fx,
     // go bond by bond
     for (int bnd_idx = 0; bnd_idx < this->info.size(); bnd_idx++)
     {
+        // resolve curve handles so that curves are not looked up by name event by event
+        this->info[bnd_idx].crv_disc_idx = crvs.get_crv_idx(this->info[bnd_idx].crv_disc);
+        this->info[bnd_idx].crv_fwd_idx = (this->info[bnd_idx].crv_fwd.size() > 0) ? crvs.get_crv_idx(this->info[bnd_idx].crv_fwd) : -1;
+
         // calculate repricing rates for floating bonds
         if (!this->info[bnd_idx].is_fixed)
         {
@@ -898,7 +944,7 @@ void myBonds::calc_npv(const int &scn_no, const myCurves &crvs, const myFx &fx,
                     if (this->info[bnd_idx].fix_type.compare("fwd") == 0)
                     {
                         // get forward rate
-                        std::vector<double> fwds = crvs.get_fwd_rate(this->info[bnd_idx].crv_fwd, scn_tenors, this->info[bnd_idx].dcm);
+                        std::vector<double> fwds = crvs.get_fwd_rate(this->info[bnd_idx].crv_fwd_idx, scn_tenors, this->info[bnd_idx].dcm_type);
 
                         // use the forward rate as a coupon rate
                         this->info[bnd_idx].events[idx].cpn = fwds[0];
@@ -908,7 +954,7 @@ void myBonds::calc_npv(const int &scn_no, const myCurves &crvs, const myFx &fx,
                     {
                         // get par-rate
                         int par_step = this->info[bnd_idx].events[idx].repricing_dates.size() - 1;
-                        std::vector<double> pars = crvs.get_par_rate(this->info[bnd_idx].crv_fwd, scn_tenors, this->info[bnd_idx].events[idx].par_nominals_begin, this->info[bnd_idx].events[idx].par_nominals_end, par_step, this->info[bnd_idx].dcm);
+                        std::vector<double> pars = crvs.get_par_rate(this->info[bnd_idx].crv_fwd_idx, scn_tenors, this->info[bnd_idx].events[idx].par_nominals_begin, this->info[bnd_idx].events[idx].par_nominals_end, par_step, this->info[bnd_idx].dcm_type);
 
                         // user the par-rate as a coupon rate
                         this->info[bnd_idx].events[idx].cpn = pars[0];
@@ -935,7 +981,7 @@ void myBonds::calc_npv(const int &scn_no, const myCurves &crvs, const myFx &fx,
             scn_tenors.push_back(std::tuple<int, int>(scn_no, this->info[bnd_idx].events[idx].date_end.get_date_int()));
             
             // get discounting factor
-            std::vector<double> dfs = crvs.get_df(this->info[bnd_idx].crv_disc, scn_tenors);
+            std::vector<double> dfs = crvs.get_df(this->info[bnd_idx].crv_disc_idx, scn_tenors);
 
             // store discount factor
             this->info[bnd_idx].events[idx].df = dfs[0];
@@ -197,6 +197,7 @@ int main()
 #include <vector>
 #include <thread>
 #include "lib_date.h"
+#include "fin_date.h"
 #include "fin_curve.h"
 #include "fin_fx.h"
 
@@ -242,21 +243,29 @@ struct bnd_info
 	myDate value_date;
 	myDate maturity_date;
     std::string dcm;
+    dcm_method dcm_type = dcm_method::undefined; // day count method resolved from dcm
     bool is_acc_int = false;
     double acc_int = 0.0;
     double acc_int_ref_ccy = 0.0;
 	double cpn_rate = 0.0;
 	myDate first_cpn_date;
 	std::string cpn_freq;
+    tenor_def cpn_tenor; // tenor parsed from cpn_freq once per contract
 	myDate first_fix_date;
 	std::string fix_freq;
+    tenor_def fix_tenor; // tenor parsed from fix_freq once per contract
 	myDate first_amort_date;
 	std::string amort_freq;
+    tenor_def amort_tenor; // tenor parsed from amort_freq once per contract
 	double amort = 0.0;
 	double rate_mult = 0.0;
 	double rate_add = 0.0;
 	std::string crv_disc;
 	std::string crv_fwd;
+    std::string cal_nm; // holiday calendar of coupon, amortization and repricing dates
+    bday_conv conv = bday_conv::unadjusted; // business day convention applied to the dates
+    int crv_disc_idx = -1; // curve handles resolved when NPV is calculated
+    int crv_fwd_idx = -1;
     double npv = 0.0;
     double npv_ref_ccy = 0.0;
     std::string wrn_msg = "";
@@ -276,7 +285,7 @@ class myBonds
     public:
         // object constructors
         myBonds(std::vector<bnd_info> info){this->info = info;};
-        myBonds(const mySQLite &db, const std::string &sql, const myDate &calc_date);
+        myBonds(const mySQLite &db, const std::string &sql, const myDate &calc_date, const myCalendars * cals = nullptr);
 
         // copy constructor
         myBonds(const myBonds &bnds){this->info = bnds.info;};
@@ -52,7 +52,7 @@ static std::vector<myDate> extract_dates_from_events(const std::vector<cap_flr_e
  * OBJECT CONSTRUCTORS
  */
 
-myCapsFloors::myCapsFloors(const mySQLite &db, const std::string &sql, const myDate &calc_date)
+myCapsFloors::myCapsFloors(const mySQLite &db, const std::string &sql, const myDate &calc_date, const myCalendars * cals)
 {
     // dataframe to hold result of SQL query
     myDataFrame * rslt = new myDataFrame();
@@ -63,7 +63,8 @@ myCapsFloors::myCapsFloors(const mySQLite &db, const std::string &sql, const myD
     // auxiliary variables
     std::string aux;
     myDate date_aux;
-    std::vector<myDate> event_dates;
+    date_serie_ptr event_dates;
+    date_serie_ptr adj_event_dates;
     std::vector<myDate> begin_int_dates;
     std::vector<myDate> end_int_dates;
 
@@ -135,6 +136,7 @@ myCapsFloors::myCapsFloors(const mySQLite &db, const std::string &sql, const myD
 
             // day count method used to calculate interent payment
             cap_flr.dcm = rslt->tbl.values[cap_flr_idx][15];
+            cap_flr.dcm_type = get_dcm_method(cap_flr.dcm);
             
             // cap rate
             aux = rslt->tbl.values[cap_flr_idx][16];
@@ -229,6 +231,13 @@ myCapsFloors::myCapsFloors(const mySQLite &db, const std::string &sql, const myD
             // repricing curve
             cap_flr.crv_fwd = rslt->tbl.values[cap_flr_idx][28];
 
+            // holiday calendar and business day convention; the columns are missing in tables created before they
+            // were introduced
+            std::string cal_nm = (rslt->tbl.values[cap_flr_idx].size() > 29) ? rslt->tbl.values[cap_flr_idx][29] : "";
+            std::string conv_nm = (rslt->tbl.values[cap_flr_idx].size() > 30) ? rslt->tbl.values[cap_flr_idx][30] : "";
+            const myCalendar * cal = get_schedule_cal(cals, cal_nm, conv_nm, cap_flr.conv, cap_flr.wrn_msg);
+            cap_flr.cal_nm = (cal != nullptr) ? cal_nm : "";
+
         // perform other sanity checks
        
             // value date
@@ -319,6 +328,18 @@ myCapsFloors::myCapsFloors(const mySQLite &db, const std::string &sql, const myD
                 }
             }
 
+        // parse frequencies into tenors; events are generated without any further string manipulation
+
+            cap_flr.int_tenor = parse_tenor(cap_flr.int_freq);
+            if (cap_flr.amort_freq.compare("") != 0)
+            {
+                cap_flr.amort_tenor = parse_tenor(cap_flr.amort_freq);
+            }
+            if (cap_flr.fix_freq.compare("") != 0)
+            {
+                cap_flr.fix_tenor = parse_tenor(cap_flr.fix_freq);
+            }
+
         // generate vector of events
 
             // variables containing dates
@@ -331,9 +352,7 @@ myCapsFloors::myCapsFloors(const mySQLite &db, const std::string &sql, const myD
 
             // position index
             int pos_idx;
-
-            // date format, which is used to store date string in object myDate
-            std::string date_format = "yyyymmdd";
+            std::vector<int> pos_idxs;
 
             // find date of the first interest payment and a create vector interest events;
             // we assume that all other events occur on interest payment dates
@@ -341,25 +360,31 @@ myCapsFloors::myCapsFloors(const mySQLite &db, const std::string &sql, const myD
             // iterate until you find the first interest payment period that does not preceed calculation date
             date1 = cap_flr.first_int_date;
             date2 = cap_flr.first_int_date;
-            date2.remove(cap_flr.int_freq);
+            date2.remove(cap_flr.int_tenor);
             while ((date1.get_days_no() < calc_date.get_days_no()) & (date2.get_days_no() < calc_date.get_days_no()))
             {
                 date1 = date2;
-                date2.add(cap_flr.int_freq);
+                date2.add(cap_flr.int_tenor);
             }
             
             // date1 represents the beginning date of such coupon period => we generate coupon dates till maturity
-            event_dates = create_date_serie(date1.get_date_str(), cap_flr.maturity_date.get_date_str(), cap_flr.int_freq, date_format);     
+            event_dates = get_date_serie(date1, cap_flr.maturity_date, cap_flr.int_tenor);
+            adj_event_dates = (cal != nullptr) ? get_date_serie(date1, cap_flr.maturity_date, cap_flr.int_tenor, *cal, cap_flr.conv) : event_dates;
 
-            // create a vector of events based on coupon dates
-            for (int idx = 0; idx < event_dates.size(); idx++)
+            // create a vector of events based on coupon dates; interest periods are rolled on unadjusted dates and
+            // both of their ends are adjusted to business days
+            for (int idx = 0; idx < event_dates->size(); idx++)
             {
-                date1 = event_dates[idx];
-                date2 = date1;
-                date1.remove(cap_flr.int_freq);
+                date1 = (*event_dates)[idx];
+                date1.remove(cap_flr.int_tenor);
+                date2 = (*adj_event_dates)[idx];
+                if (cal != nullptr)
+                {
+                    date1 = cal->adjust(date1, cap_flr.conv);
+                }
                 evnt.date_begin = date1; // beging of coupon period
                 evnt.date_end = date2; // end of coupon period => date of coupon payment
-                evnt.int_year_frac = day_count_method(date1, date2, cap_flr.dcm);
+                evnt.int_year_frac = day_count_method(date1, date2, cap_flr.dcm_type);
 
                 // indicate that interest payment is fixed and therefore
                 // could be calculated without a scenario knowledge
@@ -387,19 +412,24 @@ myCapsFloors::myCapsFloors(const mySQLite &db, const std::string &sql, const myD
                 date1 = cap_flr.first_amort_date;
                 while (date1.get_days_no() < calc_date.get_days_no())
                 {
-                    date1.add(cap_flr.amort_freq);
+                    date1.add(cap_flr.amort_tenor);
                 }
 
                 // date1 is the first amortization date => we generate amortizaton dates till maturity
-                event_dates = create_date_serie(date1.get_date_str(), cap_flr.maturity_date.get_date_str(), cap_flr.amort_freq, date_format);
+                event_dates = get_date_serie(date1, cap_flr.maturity_date, cap_flr.amort_tenor);
+                adj_event_dates = (cal != nullptr) ? get_date_serie(date1, cap_flr.maturity_date, cap_flr.amort_tenor, *cal, cap_flr.conv) : event_dates;
+
+                // match adjusted amortization dates with the nearest interest period end dates in a single merge pass
+                pos_idxs.resize(event_dates->size());
+                match_dates(*adj_event_dates, end_int_dates, date_match::nearest, pos_idxs.data());
 
                 // go amortization date by amortization date and assign it the nearest coupon date; we assume that amortizations happen on coupon dates
-                for (int idx = 0; idx < event_dates.size(); idx++)
+                for (int idx = 0; idx < event_dates->size(); idx++)
                 {
                     // we assign amortization flag based on begining interest payment date
-                    if (event_dates[idx].get_date_int() < cap_flr.maturity_date.get_date_int())
+                    if ((*event_dates)[idx].get_date_int() < cap_flr.maturity_date.get_date_int())
                     {
-                        pos_idx = get_nearest_idx(event_dates[idx], end_int_dates, "abs");
+                        pos_idx = pos_idxs[idx];
                         events[pos_idx].amort_flg = true;
                     }
                 }
@@ -446,19 +476,24 @@ myCapsFloors::myCapsFloors(const mySQLite &db, const std::string &sql, const myD
                 date1 = cap_flr.first_fix_date;
                 while (date1.get_days_no() < calc_date.get_days_no())
                 {
-                    date1.add(cap_flr.fix_freq);
+                    date1.add(cap_flr.fix_tenor);
                 }
 
                 // date1 is the first repricing date => we generate repricing dates till maturity
-                event_dates = create_date_serie(date1.get_date_str(), cap_flr.maturity_date.get_date_str(), cap_flr.fix_freq, date_format);
+                event_dates = get_date_serie(date1, cap_flr.maturity_date, cap_flr.fix_tenor);
+                adj_event_dates = (cal != nullptr) ? get_date_serie(date1, cap_flr.maturity_date, cap_flr.fix_tenor, *cal, cap_flr.conv) : event_dates;
+
+                // match adjusted repricing dates with the nearest interest period begin dates in a single merge pass
+                pos_idxs.resize(event_dates->size());
+                match_dates(*adj_event_dates, begin_int_dates, date_match::nearest, pos_idxs.data());
 
                 // determine in which interest payment periods there will be repricing
-                for (int idx = 0; idx < event_dates.size(); idx++)
+                for (int idx = 0; idx < event_dates->size(); idx++)
                 {
                     // we assign repricing flag based on begining interest payment date
-                    if (event_dates[idx].get_date_int() < cap_flr.maturity_date.get_date_int())
+                    if ((*event_dates)[idx].get_date_int() < cap_flr.maturity_date.get_date_int())
                     {
-                        pos_idx = get_nearest_idx(event_dates[idx], begin_int_dates, "abs");
+                        pos_idx = pos_idxs[idx];
                         events[pos_idx].fix_flg = true;
                     }
                 }
@@ -477,8 +512,12 @@ myCapsFloors::myCapsFloors(const mySQLite &db, const std::string &sql, const myD
                     {
                         date1 = events[idx].date_begin;
                         date2 = date1;
-                        date2.add(cap_flr.fix_freq);
-                    
+                        date2.add(cap_flr.fix_tenor);
+                        if (cal != nullptr)
+                        {
+                            date2 = cal->adjust(date2, cap_flr.conv);
+                        }
+
                         // forward rate repricing - only the boundary dates
                         if (cap_flr.fix_type.compare("fwd") == 0)
                         {
@@ -589,6 +628,16 @@ void myCapsFloors::calc_npv(const int &scn_no, const myCurves &crvs, const myFx
     // go intrument by intrument
     for (int cap_flr_idx = 0; cap_flr_idx < this->info.size(); cap_flr_idx++)
     {
+        // resolve curve handles so that curves are not looked up by name event by event
+        this->info[cap_flr_idx].crv_disc_idx = crvs.get_crv_idx(this->info[cap_flr_idx].crv_disc);
+        this->info[cap_flr_idx].crv_fwd_idx = (this->info[cap_flr_idx].crv_fwd.size() > 0) ? crvs.get_crv_idx(this->info[cap_flr_idx].crv_fwd) : -1;
+
+        // resolve volatility surfaces compiled for the scenario; caplets and floorlets use them without any copying
+        bool is_cap_vol = (this->info[cap_flr_idx].cap_vol_surf.size() > 0);
+        bool is_floor_vol = (this->info[cap_flr_idx].floor_vol_surf.size() > 0);
+        vol_surf_handle cap_vol_surf = is_cap_vol ? vol_surfs.get_vol_handle(this->info[cap_flr_idx].cap_vol_surf, scn_no) : vol_surf_handle();
+        vol_surf_handle floor_vol_surf = is_floor_vol ? vol_surfs.get_vol_handle(this->info[cap_flr_idx].floor_vol_surf, scn_no) : vol_surf_handle();
+
         // go event by event
         for (int idx = 0; idx < this->info[cap_flr_idx].events.size(); idx++)
         {
@@ -638,7 +687,7 @@ void myCapsFloors::calc_npv(const int &scn_no, const myCurves &crvs, const myFx
                 if (this->info[cap_flr_idx].fix_type.compare("fwd") == 0)
                 {
                     // get forward rate
-                    std::vector<double> fwds = crvs.get_fwd_rate(this->info[cap_flr_idx].crv_fwd, scn_tenors, this->info[cap_flr_idx].dcm);
+                    std::vector<double> fwds = crvs.get_fwd_rate(this->info[cap_flr_idx].crv_fwd_idx, scn_tenors, this->info[cap_flr_idx].dcm_type);
 
                     // use the forward rate as a coupon rate
                     this->info[cap_flr_idx].events[idx].int_rate = fwds[0];
@@ -648,7 +697,7 @@ void myCapsFloors::calc_npv(const int &scn_no, const myCurves &crvs, const myFx
                 {
                     // get par-rate
                     int par_step = this->info[cap_flr_idx].events[idx].repricing_dates.size() - 1;
-                    std::vector<double> pars = crvs.get_par_rate(this->info[cap_flr_idx].crv_fwd, scn_tenors, this->info[cap_flr_idx].events[idx].par_nominals_begin, this->info[cap_flr_idx].events[idx].par_nominals_end, par_step, this->info[cap_flr_idx].dcm);
+                    std::vector<double> pars = crvs.get_par_rate(this->info[cap_flr_idx].crv_fwd_idx, scn_tenors, this->info[cap_flr_idx].events[idx].par_nominals_begin, this->info[cap_flr_idx].events[idx].par_nominals_end, par_step, this->info[cap_flr_idx].dcm_type);
 
                     // user the par-rate as a coupon rate
                     this->info[cap_flr_idx].events[idx].int_rate = pars[0];
@@ -656,27 +705,27 @@ void myCapsFloors::calc_npv(const int &scn_no, const myCurves &crvs, const myFx
 
                 // caplet / floorlet maturity date
                 myDate maturity = this->info[cap_flr_idx].events[idx].date_begin;
-                maturity.add(this->info[cap_flr_idx].fix_freq);
+                maturity.add(this->info[cap_flr_idx].fix_tenor);
                 this->info[cap_flr_idx].events[idx].opt_mat = (maturity.get_days_no() - this->info[cap_flr_idx].calc_date.get_days_no()) / 365.;
 
                 // volatility tenor
-                std::vector<double> tenors = {static_cast<double>(maturity.get_days_no() - this->info[cap_flr_idx].calc_date.get_days_no())};
+                double tenor = maturity.get_days_no() - this->info[cap_flr_idx].calc_date.get_days_no();
 
-                // caplet / floorlet execution date
-                double execution = (this->info[cap_flr_idx].events[idx].date_begin.get_days_no() - this->info[cap_flr_idx].calc_date.get_days_no()) / 365.;
+                // caplet / floorlet execution date; SABR surfaces are evaluated at the execution date as their time
+                // correction has to use the same expiry as the normal model
+                double tenor_fix = this->info[cap_flr_idx].events[idx].date_begin.get_days_no() - this->info[cap_flr_idx].calc_date.get_days_no();
+                double execution = tenor_fix / 365.;
 
                 // get interest rate volatility for caplets and calculation d parameter of the normal model
-                std::string cap_vol_surf_nm = this->info[cap_flr_idx].cap_vol_surf;
-                if (cap_vol_surf_nm.compare("") != 0)
+                if (is_cap_vol)
                 {
-                    // get caplet volatility
-                    std::vector<double> caplet_vols = vol_surfs.get_vols(cap_vol_surf_nm, scn_no, tenors, {this->info[cap_flr_idx].cap_rate});
-                    this->info[cap_flr_idx].events[idx].caplet_vol = caplet_vols[0];
+                    // get caplet volatility; SABR surfaces are evaluated at the interest rate of the period
+                    this->info[cap_flr_idx].events[idx].caplet_vol = cap_vol_surf.get_vol(cap_vol_surf.is_sabr() ? tenor_fix : tenor, 0.0, this->info[cap_flr_idx].events[idx].int_rate, this->info[cap_flr_idx].cap_rate);
 
                     // calculate d
                     this->info[cap_flr_idx].events[idx].caplet_d = (this->info[cap_flr_idx].events[idx].int_rate - this->info[cap_flr_idx].cap_rate) / (this->info[cap_flr_idx].events[idx].caplet_vol * std::sqrt(execution));
-                    this->info[cap_flr_idx].events[idx].caplet_n = norm_pdf({this->info[cap_flr_idx].events[idx].caplet_d})[0];
-                    this->info[cap_flr_idx].events[idx].caplet_N = norm_cdf({this->info[cap_flr_idx].events[idx].caplet_d})[0];
+                    this->info[cap_flr_idx].events[idx].caplet_n = norm_pdf(this->info[cap_flr_idx].events[idx].caplet_d);
+                    this->info[cap_flr_idx].events[idx].caplet_N = norm_cdf(this->info[cap_flr_idx].events[idx].caplet_d);
                 }
                 else
                 {
@@ -685,17 +734,15 @@ void myCapsFloors::calc_npv(const int &scn_no, const myCurves &crvs, const myFx
                 }
 
                 // get interest rate volatility for floorlets and calculation d parameter of the normal model
-                std::string floor_vol_surf_nm = this->info[cap_flr_idx].floor_vol_surf;
-                if (floor_vol_surf_nm.compare("") != 0)
+                if (is_floor_vol)
                 {
                     // get floorlet volatility
-                    std::vector<double> floorlet_vols = vol_surfs.get_vols(floor_vol_surf_nm, scn_no, tenors, {this->info[cap_flr_idx].floor_rate});
-                    this->info[cap_flr_idx].events[idx].floorlet_vol = floorlet_vols[0];
+                    this->info[cap_flr_idx].events[idx].floorlet_vol = floor_vol_surf.get_vol(floor_vol_surf.is_sabr() ? tenor_fix : tenor, 0.0, this->info[cap_flr_idx].events[idx].int_rate, this->info[cap_flr_idx].floor_rate);
                 
                     // calculate d
                     this->info[cap_flr_idx].events[idx].floorlet_d = (this->info[cap_flr_idx].events[idx].int_rate - this->info[cap_flr_idx].floor_rate) / (this->info[cap_flr_idx].events[idx].floorlet_vol * std::sqrt(execution));
-                    this->info[cap_flr_idx].events[idx].floorlet_n = norm_pdf({this->info[cap_flr_idx].events[idx].floorlet_d})[0];
-                    this->info[cap_flr_idx].events[idx].floorlet_N = norm_cdf({-this->info[cap_flr_idx].events[idx].floorlet_d})[0];
+                    this->info[cap_flr_idx].events[idx].floorlet_n = norm_pdf(this->info[cap_flr_idx].events[idx].floorlet_d);
+                    this->info[cap_flr_idx].events[idx].floorlet_N = norm_cdf(-this->info[cap_flr_idx].events[idx].floorlet_d);
                 }
                 else
                 {
@@ -713,7 +760,7 @@ void myCapsFloors::calc_npv(const int &scn_no, const myCurves &crvs, const myFx
             scn_tenors.push_back(std::tuple<int, int>(scn_no, this->info[cap_flr_idx].events[idx].date_end.get_date_int()));
             
             // get discounting factor
-            std::vector<double> dfs = crvs.get_df(this->info[cap_flr_idx].crv_disc, scn_tenors);
+            std::vector<double> dfs = crvs.get_df(this->info[cap_flr_idx].crv_disc_idx, scn_tenors);
 
             // store discount factor
             this->info[cap_flr_idx].events[idx].df = dfs[0];
@@ -26,6 +26,8 @@ int main()
     std::string spreadcrv_bef = "data/curves/spreadcrv_bef.csv";
     std::string vol_surf_def = "data/vol_surf_def.csv";
     std::string vol_surf_data = "data/vol_surf_data.csv";
+    std::string vol_cube_data = "data/vol_cube_data.csv";
+    std::string vol_sabr_data = "data/vol_sabr_data.csv";
     std::string cap_floor_data = "data/cap_floor_data.csv";
     std::string sql;
     myDataFrame * rslt = new myDataFrame();
@@ -68,6 +70,12 @@ int main()
     sql = read_sql(sql_file_nm, "vol_surf_data");
     db.exec(sql);
 
+    sql = read_sql(sql_file_nm, "vol_cube_data");
+    db.exec(sql);
+
+    sql = read_sql(sql_file_nm, "vol_sabr_data");
+    db.exec(sql);
+
     sql = read_sql(sql_file_nm, "cap_floor_data");
     db.exec(sql);
 
@@ -84,6 +92,8 @@ int main()
     db.exec("DELETE FROM crv_data;");
     db.exec("DELETE FROM vol_surf_def;");
     db.exec("DELETE FROM vol_surf_data;");
+    db.exec("DELETE FROM vol_cube_data;");
+    db.exec("DELETE FROM vol_sabr_data;");
     db.exec("DELETE FROM cap_floor_data;");
     db.exec("DELETE FROM cap_floor_npv;");
 
@@ -128,6 +138,14 @@ int main()
     db.upload_tbl(*rslt, "vol_surf_data", delete_old_data);
     rslt->clear();
 
+    rslt->read(vol_cube_data, sep, quotes);
+    db.upload_tbl(*rslt, "vol_cube_data", delete_old_data);
+    rslt->clear();
+
+    rslt->read(vol_sabr_data, sep, quotes);
+    db.upload_tbl(*rslt, "vol_sabr_data", delete_old_data);
+    rslt->clear();
+
     rslt->read(cap_floor_data, sep, quotes);
     db.upload_tbl(*rslt, "cap_floor_data", delete_old_data);
     rslt->clear();
@@ -217,6 +235,7 @@ int main()
 #include <vector>
 #include <thread>
 #include "lib_date.h"
+#include "fin_date.h"
 #include "fin_curve.h"
 #include "fin_fx.h"
 #include "fin_vol_surf.h"
@@ -271,19 +290,27 @@ struct cap_flr_info
 	myDate value_date;
 	myDate maturity_date;
     std::string dcm;
+    dcm_method dcm_type = dcm_method::undefined; // day count method resolved from dcm
     double cap_rate = 0.0;
     std::string cap_vol_surf;
     double floor_rate = 0.0;
     std::string floor_vol_surf;
 	myDate first_int_date;
 	std::string int_freq;
+    tenor_def int_tenor; // tenor parsed from int_freq once per contract
 	myDate first_fix_date;
 	std::string fix_freq;
+    tenor_def fix_tenor; // tenor parsed from fix_freq once per contract
 	myDate first_amort_date;
 	std::string amort_freq;
+    tenor_def amort_tenor; // tenor parsed from amort_freq once per contract
 	double amort = 0.0;
 	std::string crv_disc;
 	std::string crv_fwd;
+    std::string cal_nm; // holiday calendar of interest, fixing and amortization dates
+    bday_conv conv = bday_conv::unadjusted; // business day convention applied to the dates
+    int crv_disc_idx = -1; // curve handles resolved when NPV is calculated
+    int crv_fwd_idx = -1;
     double cap_npv = 0.0;
     double cap_npv_ref_ccy = 0.0;
     double floor_npv = 0.0;
@@ -307,7 +334,7 @@ class myCapsFloors
     public:
         // object constructors
         myCapsFloors(std::vector<cap_flr_info> info){this->info = info;};
-        myCapsFloors(const mySQLite &db, const std::string &sql, const myDate &calc_date);
+        myCapsFloors(const mySQLite &db, const std::string &sql, const myDate &calc_date, const myCalendars * cals = nullptr);
 
         // copy constructor
         myCapsFloors(const myCapsFloors &caps_flrs){this->info = caps_flrs.info;};
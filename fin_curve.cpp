@@ -3,17 +3,165 @@
 #include <math.h>
 #include <tuple> 
 #include <vector>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <functional>
+#include <algorithm>
+#include <iterator>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "lib_aux.h"
+#include "lib_math.h"
 #include "lib_sqlite.h"
-#include "lib_lininterp.h"
 #include "fin_date.h"
 #include "fin_curve.h"
 
+/*
+ * AUXILIARY FUNCTIONS
+ */
+
+// calculate year fractions of periods between consecutive dates
+static std::vector<double> calc_period_year_fracs(const std::vector<myDate> &dates, const dcm_method &dcm)
+{
+    if (dates.size() < 2)
+    {
+        return std::vector<double>();
+    }
+    std::vector<double> d_t(dates.size() - 1);
+    year_fractions(std::vector<myDate>(dates.begin(), dates.end() - 1), std::vector<myDate>(dates.begin() + 1, dates.end()), dcm, d_t.data());
+    return d_t;
+}
+
+// calculate par-rates of all windows of step periods from discount factors dfs; amortization payments and
+// discounted coupon year fractions are accumulated into prefix sums so that each window is evaluated in O(1)
+static void calc_par_rates(const double * dfs, const std::vector<double> &d_t, const std::vector<double> &nominals_begin, const std::vector<double> &nominals_end, const int &step, double * pars)
+{
+    // number of windows
+    int dates_no = d_t.size() + 1;
+    int windows_no = dates_no - step;
+    if (windows_no <= 0)
+    {
+        return;
+    }
+
+    // prefix sums of discounted amortization payments and discounted coupon year fractions
+    std::vector<double> amorts_sum(dates_no, 0.0);
+    std::vector<double> cpns_sum(dates_no, 0.0);
+    for (int idx = 1; idx < dates_no; idx++)
+    {
+        amorts_sum[idx] = amorts_sum[idx - 1] + dfs[idx] * (nominals_begin[idx] - nominals_end[idx]);
+        cpns_sum[idx] = cpns_sum[idx - 1] + d_t[idx - 1] * dfs[idx] * nominals_begin[idx];
+    }
+
+    // calculate par-rate of each window
+    for (int idx = 0; idx < windows_no; idx++)
+    {
+        double par = dfs[idx] * nominals_end[idx] - dfs[idx + step] * nominals_end[idx + step];
+        par -= amorts_sum[idx + step] - amorts_sum[idx];
+        pars[idx] = par / (cpns_sum[idx + step] - cpns_sum[idx]);
+    }
+}
+
+// block of scenario rows of a curve to be interpolated by a single thread
+struct crv_block_def
+{
+    myCurve * crv;
+    int scn_row_first;
+    int scn_row_last;
+};
+
+// interpolate blocks of scenario rows; function is run by individual threads
+static void calc_crv_blocks(const std::vector<crv_block_def> &blocks)
+{
+    for (int block_idx = 0; block_idx < blocks.size(); block_idx++)
+    {
+        blocks[block_idx].crv->calc_scns(blocks[block_idx].scn_row_first, blocks[block_idx].scn_row_last);
+    }
+}
+
+// binary cache file layout; the version has to be increased whenever the layout, the date arithmetic or the way
+// curve points are interpolated changes, since cache files of older versions would be reused otherwise
+static const char crv_cache_magic[8] = {'F', 'I', 'N', 'C', 'R', 'V', 'S', '\0'};
+static const uint32_t crv_cache_version = 4;
+static const long crv_cache_header_size = 32;
+
+// append value to binary buffer
+template <typename T>
+static void put_value(std::string &buffer, const T &value)
+{
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+// append string to binary buffer
+static void put_string(std::string &buffer, const std::string &value)
+{
+    put_value<uint32_t>(buffer, value.size());
+    buffer.append(value);
+}
+
+// append vector to binary buffer
+template <typename T>
+static void put_vector(std::string &buffer, const std::vector<T> &values)
+{
+    put_value<uint32_t>(buffer, values.size());
+    buffer.append(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+}
+
+// read value from binary buffer; false is returned if the buffer is too short
+template <typename T>
+static bool get_value(const char * &cursor, const char * end, T &value)
+{
+    if (end - cursor < static_cast<long>(sizeof(T)))
+    {
+        return false;
+    }
+    memcpy(&value, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return true;
+}
+
+// read string from binary buffer; false is returned if the buffer is too short
+static bool get_string(const char * &cursor, const char * end, std::string &value)
+{
+    uint32_t size;
+    if (!get_value(cursor, end, size) || (end - cursor < static_cast<long>(size)))
+    {
+        return false;
+    }
+    value.assign(cursor, size);
+    cursor += size;
+    return true;
+}
+
+// read vector from binary buffer; false is returned if the buffer is too short
+template <typename T>
+static bool get_vector(const char * &cursor, const char * end, std::vector<T> &values)
+{
+    uint32_t size;
+    if (!get_value(cursor, end, size) || ((end - cursor) / static_cast<long>(sizeof(T)) < static_cast<long>(size)))
+    {
+        return false;
+    }
+    values.resize(size);
+    memcpy(values.data(), cursor, size * sizeof(T));
+    cursor += size * sizeof(T);
+    return true;
+}
+
 /*
  * OBJECT CONSTRUCTORS
  */
 
 // object containing information on a single curve
-myCurve::myCurve(const mySQLite &db, const std::string &sql_file_nm, const std::string &crv_nm, const myDate &calc_date)
+myCurve::myCurve(const mySQLite &db, const std::string &sql_file_nm, const std::string &crv_nm, const myDate &calc_date, const bool &is_lazy, const int &threads_no, const std::map<std::string, myCurve> * crvs)
 {
     // dataframe to hold result of SQL query
     myDataFrame * rslt = new myDataFrame();
@@ -28,12 +176,17 @@ myCurve::myCurve(const mySQLite &db, const std::string &sql_file_nm, const std::
 
     // initiate curve definition variables
     this->calc_date = calc_date;
+    this->is_lazy = is_lazy;
+    this->cache = std::make_shared<crv_cache_def>();
     this->crv_nm = rslt->tbl.values[0][0];
     this->ccy_nm = rslt->tbl.values[0][1];
     this->dcm = rslt->tbl.values[0][2];
+    this->dcm_type = get_dcm_method(this->dcm);
     this->crv_type = rslt->tbl.values[0][3];
     this->underlying1 = rslt->tbl.values[0][4];
     this->underlying2 = rslt->tbl.values[0][5];
+    this->interp = rslt->tbl.values[0][6];
+    this->tenors_no = 120 * 365;
 
     // base curve
     if (this->crv_type.compare("base") == 0)
@@ -42,16 +195,37 @@ myCurve::myCurve(const mySQLite &db, const std::string &sql_file_nm, const std::
         sql = read_sql(sql_file_nm, "load_base_crv_data");
         sql = replace_in_sql(sql, "##crv_nm##", "'" + this->crv_nm + "'");
         rslt = db.query(sql);
-    
+
+        // store curve knots
+        this->load_knots(*rslt);
     }
     // compound curve
     else if (this->crv_type.compare("compound") == 0)
     {
-        // retrieve data
-        sql = read_sql(sql_file_nm, "load_compound_crv_data");
-        sql = replace_in_sql(sql, "##crv_nm1##", "'" + this->underlying1 + "'");
-        sql = replace_in_sql(sql, "##crv_nm2##", "'" + this->underlying2 + "'");
-        rslt = db.query(sql);
+        // underlying curves are taken from already loaded curves; curve knots of other underlying curves are loaded
+        // directly from the database
+        std::string underlyings[2] = {this->underlying1, this->underlying2};
+        const myCurve * crvs_und[2];
+        myCurve crvs_db[2];
+        for (int und_idx = 0; und_idx < 2; und_idx++)
+        {
+            if ((crvs != nullptr) && (crvs->count(underlyings[und_idx]) > 0))
+            {
+                crvs_und[und_idx] = &crvs->at(underlyings[und_idx]);
+            }
+            else
+            {
+                sql = read_sql(sql_file_nm, "load_base_crv_data");
+                sql = replace_in_sql(sql, "##crv_nm##", "'" + underlyings[und_idx] + "'");
+                rslt = db.query(sql);
+                crvs_db[und_idx].crv_nm = underlyings[und_idx];
+                crvs_db[und_idx].load_knots(*rslt);
+                crvs_und[und_idx] = &crvs_db[und_idx];
+            }
+        }
+
+        // compose curve knots
+        this->compose_knots(*crvs_und[0], *crvs_und[1]);
     }
     // unsupported curve type
     else
@@ -59,68 +233,29 @@ myCurve::myCurve(const mySQLite &db, const std::string &sql_file_nm, const std::
         throw std::invalid_argument((std::string)__func__ + ": " + this->crv_type + " is not a supported date std::string format!");
     }
 
-    // prepare vector of tenors for which we want to interporate the curve
-    std::vector<double> tenors;
-    std::vector<myDate> tenor_dates;
-    for (double tenor = 1; tenor < (120 * 365 + 1); tenor++)
-    {
-        tenors.push_back(tenor);
-        myDate tenor_date = this->calc_date;
-        tenor_date.add(std::to_string(tenor) + "D");
-        tenor_dates.push_back(tenor_date);
-    }
+    // prepare interpolation of individual scenarios
+    this->calc_interps();
 
-    // go scenario by scenario
-    int scn_no = -1;
-    bool is_new_scn = false;
-    std::vector<double> _tenors;
-    std::vector<double> _rates;
-
-    for (int idx = 0; idx < rslt->tbl.values.size(); idx++)
+    // lazy curve => curve points are interpolated once they are requested
+    if (!this->is_lazy)
     {
-        // check that you have encountered a new scenario or you are at the end of file
-        if (((stoi(rslt->tbl.values[idx][0]) != scn_no) && (scn_no != -1)) || (idx == rslt->tbl.values.size() - 1))
-        {
-            // interpolate rates
-            myLinInterp interp(_tenors, _rates);
-            std::vector<double> rates = interp.eval(tenors);
+        // prepare year fractions and dense curve storage
+        this->alloc_dense();
 
-            // go scenario line by line
-            for (int idx2 = 0; idx2 < rates.size(); idx2++)
+        // split scenarios into blocks and interpolate them in individual threads
+        int blocks_no = std::max(1, std::min(threads_no, this->scns_no));
+        if (this->scns_no > 0)
+        {
+            std::vector<coordinates<int>> indicies = split_vector(this->scns_no, blocks_no);
+            std::vector<std::thread> workers;
+            for (int block_idx = 0; block_idx < blocks_no; block_idx++)
             {
-                // create a tuple of scenario and tenor date integer in yyyymmdd format
-                std::tuple<int, int> scn_tenor = {scn_no, tenor_dates[idx2].get_date_int()};
-
-                // create tenor and store rate into it
-                tenor_def tenor;
-                tenor.tenor = tenors[idx2];
-                tenor.tenor_date = tenor_dates[idx2];
-                tenor.rate = rates[idx2];
-
-                // calculate year fraction
-                tenor.year_frac = day_count_method(this->calc_date, tenor.tenor_date, this->dcm);
-                tenor.year_frac_aux2 = floor(tenor.year_frac);
-                tenor.year_frac_aux1 = tenor.year_frac - tenor.year_frac_aux2;
-
-                // calculate discount factor
-                tenor.df = 1. / (1 + tenor.rate * tenor.year_frac_aux1) * 1. / pow((1 + tenor.rate), tenor.year_frac_aux2);
-
-                // calculate zero rate
-                tenor.zero_rate = pow(tenor.df, -1. / tenor.year_frac) - 1;
-
-                // add tenor to curve object
-                this->tenor.insert(std::pair<std::tuple<int, int>, tenor_def>(scn_tenor, tenor));
-
-                // update scenario and clear variables
-                _tenors.clear();
-                _rates.clear();
+                workers.emplace_back(&myCurve::calc_scns, this, indicies[block_idx].x, indicies[block_idx].y);
+            }
+            for (int block_idx = 0; block_idx < blocks_no; block_idx++)
+            {
+                workers[block_idx].join();
             }
-        }
-        // load data
-        {
-            scn_no = stoi(rslt->tbl.values[idx][0]);
-            _tenors.push_back(stod(rslt->tbl.values[idx][1]));
-            _rates.push_back(stod(rslt->tbl.values[idx][2]));
         }
     }
 
@@ -129,8 +264,21 @@ myCurve::myCurve(const mySQLite &db, const std::string &sql_file_nm, const std::
 }
 
 // object containing information on all curves
-myCurves::myCurves(const mySQLite &db, const std::string &sql_file_nm, const myDate &calc_date)
+myCurves::myCurves(const mySQLite &db, const std::string &sql_file_nm, const myDate &calc_date, const bool &is_lazy, const int &threads_no, const std::string &cache_file_nm)
 {
+    // interpolated curves are mapped from binary cache file if the file was built from the same curve data
+    // and calculation date
+    bool is_cached = !is_lazy && (cache_file_nm.size() > 0);
+    uint64_t hash = 0;
+    if (is_cached)
+    {
+        hash = this->calc_cache_hash(db, sql_file_nm, calc_date);
+        if (this->read_cache(cache_file_nm, hash, calc_date))
+        {
+            return;
+        }
+    }
+
     // dataframe to hold result of SQL query
     myDataFrame * rslt = new myDataFrame();
 
@@ -141,23 +289,404 @@ myCurves::myCurves(const mySQLite &db, const std::string &sql_file_nm, const myD
     sql = read_sql(sql_file_nm, "load_all_crv_nms");
     rslt = db.query(sql);
 
-    // load curve by curve
+    // load curve by curve; only curve knots are loaded at this stage
     std::string crv_nm;
     for (int crv_idx = 0; crv_idx < rslt->tbl.values.size(); crv_idx++)
     {
         crv_nm = rslt->tbl.values[crv_idx][0];
-        myCurve crv = myCurve(db, sql_file_nm, crv_nm, calc_date);
+        myCurve crv = myCurve(db, sql_file_nm, crv_nm, calc_date, true, 1, &this->crv);
         this->crv.insert(std::pair<std::string, myCurve>(crv_nm, crv));
     }
 
+    // compound curves whose underlying curves share tenors of curve knots are evaluated as views
+    if (!is_lazy)
+    {
+        for (std::map<std::string, myCurve>::iterator it = this->crv.begin(); it != this->crv.end(); it++)
+        {
+            myCurve &crv = it->second;
+            if ((crv.crv_type.compare("compound") == 0) && (this->crv.count(crv.underlying1) > 0) && (this->crv.count(crv.underlying2) > 0))
+            {
+                crv.is_view = crv.is_view_of(this->crv.at(crv.underlying1), this->crv.at(crv.underlying2));
+            }
+        }
+    }
+
+    // bind views and curve handles to the stored curves
+    this->bind_crvs();
+
+    // interpolate curves across curves and scenario blocks in individual threads
+    if (!is_lazy)
+    {
+        // prepare blocks of scenarios; each curve is split into at most threads_no blocks, but at least one block is
+        // needed for any curve with scenarios as dense storage is not filled otherwise
+        std::vector<crv_block_def> blocks;
+        for (std::map<std::string, myCurve>::iterator it = this->crv.begin(); it != this->crv.end(); it++)
+        {
+            it->second.is_lazy = false;
+            it->second.alloc_dense();
+            int blocks_no = (it->second.is_view || (it->second.scns_no == 0)) ? 0 : std::max(1, std::min(threads_no, it->second.scns_no));
+            if (blocks_no > 0)
+            {
+                std::vector<coordinates<int>> indicies = split_vector(it->second.scns_no, blocks_no);
+                for (int block_idx = 0; block_idx < blocks_no; block_idx++)
+                {
+                    blocks.push_back({&(it->second), indicies[block_idx].x, indicies[block_idx].y});
+                }
+            }
+        }
+
+        // distribute blocks among threads
+        int workers_no = std::max(1, std::min(threads_no, static_cast<int>(blocks.size())));
+        std::vector<std::vector<crv_block_def>> blocks_thrd(workers_no);
+        for (int block_idx = 0; block_idx < blocks.size(); block_idx++)
+        {
+            blocks_thrd[block_idx % workers_no].push_back(blocks[block_idx]);
+        }
+
+        // run individual threads and wait for them to finish
+        std::vector<std::thread> workers;
+        for (int thread_idx = 0; thread_idx < workers_no; thread_idx++)
+        {
+            workers.emplace_back(calc_crv_blocks, std::cref(blocks_thrd[thread_idx]));
+        }
+        for (int thread_idx = 0; thread_idx < workers_no; thread_idx++)
+        {
+            workers[thread_idx].join();
+        }
+    }
+
+    // store interpolated curves into binary cache file
+    if (is_cached)
+    {
+        this->write_cache(cache_file_nm, hash);
+    }
+
     // delete unused pointers
     delete rslt;
 }
 
+// copy of object containing information on all curves; views are bound to the copied underlying curves
+myCurves::myCurves(const myCurves &crvs)
+{
+    this->crv = crvs.crv;
+    this->bind_crvs();
+}
+
 /*
  * OBJECT FUNCTIONS
  */
 
+// register scenario and store its curve knots
+void myCurve::add_scn(const int &scn_no, const std::vector<double> &tenors, const std::vector<double> &rates)
+{
+    // check that the scenario has not been loaded already
+    if ((scn_no < this->scn_pos.size()) && (this->scn_pos[scn_no] != -1))
+    {
+        throw std::runtime_error((std::string)__func__ + ": Scenario " + std::to_string(scn_no) + " of curve " + this->crv_nm + " is not stored in a single block!");
+    }
+
+    // register scenario row
+    if (scn_no >= this->scn_pos.size())
+    {
+        this->scn_pos.resize(scn_no + 1, -1);
+    }
+    this->scn_pos[scn_no] = this->scns_no;
+    this->scns_no++;
+
+    // store curve knots
+    this->knot_tenors.push_back(tenors);
+    this->knot_rates.push_back(rates);
+}
+
+// store curve knots from result of SQL query; the rows are ordered by scenario number and tenor
+void myCurve::load_knots(const myDataFrame &rslt)
+{
+    // go scenario by scenario
+    int idx_begin = 0;
+    while (idx_begin < rslt.tbl.values.size())
+    {
+        // collect curve points of a single scenario
+        int scn_no = stoi(rslt.tbl.values[idx_begin][0]);
+        int idx_end = idx_begin;
+        std::vector<double> _tenors;
+        std::vector<double> _rates;
+        while ((idx_end < rslt.tbl.values.size()) && (stoi(rslt.tbl.values[idx_end][0]) == scn_no))
+        {
+            _tenors.push_back(stod(rslt.tbl.values[idx_end][1]));
+            _rates.push_back(stod(rslt.tbl.values[idx_end][2]));
+            idx_end++;
+        }
+        idx_begin = idx_end;
+
+        // store curve knots
+        this->add_scn(scn_no, _tenors, _rates);
+    }
+}
+
+// compose curve knots of a compound curve by summing rates of the underlying curves; only scenarios and tenors
+// available in both underlying curves are kept
+void myCurve::compose_knots(const myCurve &crv1, const myCurve &crv2)
+{
+    // go scenario by scenario in order of scenario numbers
+    for (int scn_no = 0; scn_no < crv1.scn_pos.size(); scn_no++)
+    {
+        // skip scenarios missing in either of the underlying curves
+        if ((crv1.scn_pos[scn_no] == -1) || (scn_no >= crv2.scn_pos.size()) || (crv2.scn_pos[scn_no] == -1))
+        {
+            continue;
+        }
+
+        // knots of the underlying curves
+        const std::vector<double> &tenors1 = crv1.knot_tenors[crv1.scn_pos[scn_no]];
+        const std::vector<double> &rates1 = crv1.knot_rates[crv1.scn_pos[scn_no]];
+        const std::vector<double> &tenors2 = crv2.knot_tenors[crv2.scn_pos[scn_no]];
+        const std::vector<double> &rates2 = crv2.knot_rates[crv2.scn_pos[scn_no]];
+
+        // merge knots with common tenors; the tenors are sorted in ascending order
+        std::vector<double> _tenors;
+        std::vector<double> _rates;
+        int idx1 = 0;
+        int idx2 = 0;
+        while ((idx1 < tenors1.size()) && (idx2 < tenors2.size()))
+        {
+            if (tenors1[idx1] < tenors2[idx2])
+            {
+                idx1++;
+            }
+            else if (tenors2[idx2] < tenors1[idx1])
+            {
+                idx2++;
+            }
+            else
+            {
+                _tenors.push_back(tenors1[idx1]);
+                _rates.push_back(rates1[idx1] + rates2[idx2]);
+                idx1++;
+                idx2++;
+            }
+        }
+
+        // store curve knots
+        if (_tenors.size() > 0)
+        {
+            this->add_scn(scn_no, _tenors, _rates);
+        }
+    }
+}
+
+// check whether compound curve could be evaluated as a view on the underlying curves, i.e. both underlying curves
+// share tenors of curve knots in all scenarios and all the curves interpolate rates linearly; linear interpolation
+// of the summed knots then equals sum of interpolated rates of the underlying curves
+bool myCurve::is_view_of(const myCurve &crv1, const myCurve &crv2) const
+{
+    // only linear interpolation of rates is additive
+    if ((this->interp.compare("linear") != 0) || (crv1.interp.compare("linear") != 0) || (crv2.interp.compare("linear") != 0))
+    {
+        return false;
+    }
+
+    for (int scn_no = 0; scn_no < this->scn_pos.size(); scn_no++)
+    {
+        if (this->scn_pos[scn_no] == -1)
+        {
+            continue;
+        }
+        const std::vector<double> &tenors = this->knot_tenors[this->scn_pos[scn_no]];
+        if ((tenors != crv1.knot_tenors[crv1.scn_pos[scn_no]]) || (tenors != crv2.knot_tenors[crv2.scn_pos[scn_no]]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// get scenario number of the loaded scenario a shocked scenario is based on; other scenario numbers are returned as they are
+int myCurve::get_base_scn(const int &scn_no) const
+{
+    int base_scn_no = scn_no;
+    std::map<int, crv_shock_def>::const_iterator it = this->shocks.find(base_scn_no);
+    while (it != this->shocks.end())
+    {
+        base_scn_no = it->second.base_scn_no;
+        it = this->shocks.find(base_scn_no);
+    }
+    return base_scn_no;
+}
+
+// get position of scenario number and tenor integer date in yyyymmdd format within the dense curve storage
+long myCurve::get_pos(const std::tuple<int, int> &tenor) const
+{
+    // scenario row; shocked scenario shares position with its base scenario
+    int scn_no = this->get_base_scn(std::get<0>(tenor));
+    if ((scn_no < 0) || (scn_no >= this->scn_pos.size()) || (this->scn_pos[scn_no] == -1))
+    {
+        throw std::out_of_range((std::string)__func__ + ": Scenario " + std::to_string(scn_no) + " is not available for curve " + this->crv_nm + "!");
+    }
+
+    // tenor expressed as number of days from calculation date
+    long tenor_days = calc_days_no(std::get<1>(tenor)) - this->calc_date.get_days_no();
+    if ((tenor_days < 1) || (tenor_days > this->tenors_no))
+    {
+        throw std::out_of_range((std::string)__func__ + ": Tenor " + std::to_string(std::get<1>(tenor)) + " is out of range of curve " + this->crv_nm + "!");
+    }
+
+    // return position
+    return static_cast<long>(this->scn_pos[scn_no]) * this->tenors_no + tenor_days - 1;
+}
+
+// prepare interpolation objects of individual scenarios; interpolation coefficients are calculated only once
+void myCurve::calc_interps()
+{
+    this->interps.clear();
+    this->interps.reserve(this->scns_no);
+    for (int scn_row = 0; scn_row < this->scns_no; scn_row++)
+    {
+        // year fractions of curve knots
+        std::vector<myDate> tenor_dates(this->knot_tenors[scn_row].size(), this->calc_date);
+        for (int idx = 0; idx < tenor_dates.size(); idx++)
+        {
+            tenor_dates[idx].add_days(static_cast<int>(round(this->knot_tenors[scn_row][idx])));
+        }
+        std::vector<double> year_fracs(tenor_dates.size());
+        year_fractions(this->calc_date, tenor_dates, this->dcm_type, year_fracs.data());
+
+        // interpolation object
+        this->interps.push_back(myCurveInterp(this->interp, this->knot_tenors[scn_row], this->knot_rates[scn_row], year_fracs));
+    }
+}
+
+// calculate year fractions, which do not depend on scenario, and allocate dense curve storage
+void myCurve::alloc_dense()
+{
+    // dense curve storage; a view has only year fractions as its rates are taken from the underlying curves
+    long points_no = this->is_view ? 0 : static_cast<long>(this->scns_no) * this->tenors_no;
+    this->dense = std::make_shared<crv_dense_def>();
+    this->dense->values.assign(this->tenors_no + 3 * points_no, 0.0);
+    this->dense->year_frac = this->dense->values.data();
+    this->dense->rate = this->dense->year_frac + this->tenors_no;
+    this->dense->df = this->dense->rate + points_no;
+    this->dense->zero_rate = this->dense->df + points_no;
+
+    // year fractions
+    std::vector<myDate> tenor_dates(this->tenors_no, this->calc_date);
+    for (int tenor = 1; tenor <= this->tenors_no; tenor++)
+    {
+        tenor_dates[tenor - 1].add_days(tenor);
+    }
+    year_fractions(this->calc_date, tenor_dates, this->dcm_type, this->dense->year_frac);
+}
+
+// interpolate curve for scenario rows scn_row_first, ..., scn_row_last into the dense curve storage;
+// individual threads could interpolate distinct blocks of scenario rows at the same time
+void myCurve::calc_scns(const int &scn_row_first, const int &scn_row_last)
+{
+    // go scenario by scenario and store rates, discount factors and zero rates into the scenario rows
+    for (int scn_row = scn_row_first; scn_row <= scn_row_last; scn_row++)
+    {
+        long pos = static_cast<long>(scn_row) * this->tenors_no;
+        this->interps[scn_row].eval(1, this->tenors_no, this->dense->year_frac, this->dense->rate + pos, this->dense->df + pos, this->dense->zero_rate + pos);
+    }
+}
+
+// get curve point based on scenario number and tenor integer date in yyyymmdd format
+crv_point_def myCurve::get_point(const std::tuple<int, int> &tenor) const
+{
+    // variable to hold curve point
+    crv_point_def point;
+
+    // shocked scenario => evaluate base scenario and shift its rate
+    if (!this->shocks.empty())
+    {
+        std::map<int, crv_shock_def>::const_iterator it = this->shocks.find(std::get<0>(tenor));
+        if (it != this->shocks.end())
+        {
+            // base curve point
+            point = this->get_point(std::tuple<int, int>(it->second.base_scn_no, std::get<1>(tenor)));
+
+            // rate shift; the shift is linearly interpolated between tenors of the shock
+            const crv_shock_def &shock = it->second;
+            long pos = this->get_pos(tenor);
+            double tenor_days = pos % this->tenors_no + 1;
+            double shift;
+            if (tenor_days <= shock.tenors[0])
+            {
+                shift = shock.shocks[0];
+            }
+            else if (tenor_days >= shock.tenors[shock.tenors.size() - 1])
+            {
+                shift = shock.shocks[shock.shocks.size() - 1];
+            }
+            else
+            {
+                int idx = std::upper_bound(shock.tenors.begin(), shock.tenors.end(), tenor_days) - shock.tenors.begin() - 1;
+                shift = shock.shocks[idx] + (shock.shocks[idx + 1] - shock.shocks[idx]) / (shock.tenors[idx + 1] - shock.tenors[idx]) * (tenor_days - shock.tenors[idx]);
+            }
+
+            // shift rate in the convention of the base curve point; rates of curves with interpolated log discount
+            // factors are zero rates, so discount factor of the base point is rescaled by the shifted zero rate,
+            // which keeps discount factors of a zero shift exact; other rates are converted as usual
+            if (this->interps[pos / this->tenors_no].get_method() == crv_interp_method::log_linear_df)
+            {
+                point.df *= fast_pow((1 + point.rate) / (1 + point.rate + shift), point.year_frac);
+                point.rate += shift;
+                point.zero_rate = point.rate;
+            }
+            else
+            {
+                point.rate += shift;
+                calc_df_zero_rate(point.rate, point.year_frac, point.df, point.zero_rate);
+            }
+            return point;
+        }
+    }
+
+    // position of the curve point
+    long pos = this->get_pos(tenor);
+
+    // compound curve evaluated as a view => sum rates of the underlying curves
+    if (this->is_view)
+    {
+        point.year_frac = this->dense->year_frac[pos % this->tenors_no];
+        point.rate = this->underlying_crv1->get_point(tenor).rate + this->underlying_crv2->get_point(tenor).rate;
+        calc_df_zero_rate(point.rate, point.year_frac, point.df, point.zero_rate);
+        return point;
+    }
+
+    // curve points have been already interpolated
+    if (!this->is_lazy)
+    {
+        point.year_frac = this->dense->year_frac[pos % this->tenors_no];
+        point.rate = this->dense->rate[pos];
+        point.df = this->dense->df[pos];
+        point.zero_rate = this->dense->zero_rate[pos];
+        return point;
+    }
+
+    // check if the curve point has been already evaluated
+    {
+        std::shared_lock<std::shared_mutex> lock(this->cache->mtx);
+        std::unordered_map<long, crv_point_def>::const_iterator it = this->cache->points.find(pos);
+        if (it != this->cache->points.end())
+        {
+            return it->second;
+        }
+    }
+
+    // interpolate the curve point
+    int scn_row = pos / this->tenors_no;
+    point.year_frac = day_count_method(this->calc_date, myDate(std::get<1>(tenor)), this->dcm_type);
+    this->interps[scn_row].eval(static_cast<double>(pos % this->tenors_no + 1), point.year_frac, point.rate, point.df, point.zero_rate);
+
+    // store the curve point into cache
+    {
+        std::unique_lock<std::shared_mutex> lock(this->cache->mtx);
+        this->cache->points.insert(std::pair<long, crv_point_def>(pos, point));
+    }
+
+    // return curve point
+    return point;
+}
+
 // get year fraction based on vector of scenario numbers and tenor integer dates in yyyymmdd format
 std::vector<double> myCurve::get_year_frac(const std::vector<std::tuple<int, int>> &tenor) const
 {
@@ -167,7 +696,7 @@ std::vector<double> myCurve::get_year_frac(const std::vector<std::tuple<int, int
     // go through the tenors on input
     for (int idx = 0; idx < tenor.size(); idx++)
     {
-        year_fracs.push_back(this->tenor.at(tenor[idx]).year_frac);
+        year_fracs.push_back(this->get_point(tenor[idx]).year_frac);
     }
 
     // return vector of zero rates
@@ -183,7 +712,9 @@ std::vector<myDate> myCurve::get_tenor_dates(const std::vector<std::tuple<int, i
     // go through the tenors on input
     for (int idx = 0; idx < tenor.size(); idx++)
     {
-        tenor_dates.push_back(this->tenor.at(tenor[idx]).tenor_date);
+        // check that the tenor is available; tenor date is the same as the requested date
+        this->get_pos(tenor[idx]);
+        tenor_dates.push_back(myDate(std::get<1>(tenor[idx])));
     }
 
     // return vector of zero rates
@@ -199,7 +730,7 @@ std::vector<double> myCurve::get_zero_rate(const std::vector<std::tuple<int, int
     // go through the tenors on input
     for (int idx = 0; idx < tenor.size(); idx++)
     {
-        zero_rates.push_back(this->tenor.at(tenor[idx]).zero_rate);
+        zero_rates.push_back(this->get_point(tenor[idx]).zero_rate);
     }
 
     // return vector of zero rates
@@ -215,7 +746,7 @@ std::vector<double> myCurve::get_df(const std::vector<std::tuple<int, int>> &ten
     // go through the tenors on input
     for (int idx = 0; idx < tenor.size(); idx++)
     {
-        dfs.push_back(this->tenor.at(tenor[idx]).df);
+        dfs.push_back(this->get_point(tenor[idx]).df);
     }
 
     // return vector of zero rates
@@ -223,22 +754,22 @@ std::vector<double> myCurve::get_df(const std::vector<std::tuple<int, int>> &ten
 }
 
 // calculate forward rate based on vector scenarios numbers and tenors
-std::vector<double> myCurve::get_fwd_rate(const std::vector<std::tuple<int, int>> &tenor, const std::string &dcm) const
+std::vector<double> myCurve::get_fwd_rate(const std::vector<std::tuple<int, int>> &tenor, const dcm_method &dcm) const
 {
     // create vector to hold data
     std::vector<double> fwds;
 
-    // get tenor dates and corresponding discount factors
+    // get tenor dates, corresponding discount factors and year fractions
     std::vector<myDate> tenor_dates = this->get_tenor_dates(tenor);
     std::vector<double> dfs = this->get_df(tenor);
+    std::vector<double> d_t = calc_period_year_fracs(tenor_dates, dcm);
     
     // calculate forward rates
     for (int idx = 0; idx < dfs.size() - 1; idx++)
     {
         double df1 = dfs[idx];
         double df2 = dfs[idx + 1];
-        double d_t = day_count_method(tenor_dates[idx], tenor_dates[idx + 1], dcm);
-        double fwd = (df1 / df2 - 1) / d_t;
+        double fwd = (df1 / df2 - 1) / d_t[idx];
         fwds.push_back(fwd);
     }
 
@@ -247,43 +778,459 @@ std::vector<double> myCurve::get_fwd_rate(const std::vector<std::tuple<int, int>
 }
 
 // calculate par rate based on vector scenarios numbers, tenors and nominals
-std::vector<double> myCurve::get_par_rate(const std::vector<std::tuple<int, int>> &tenor, const std::vector<double> &nominals_begin, const std::vector<double> &nominals_end, const int &step, const std::string &dcm) const
+std::vector<double> myCurve::get_par_rate(const std::vector<std::tuple<int, int>> &tenor, const std::vector<double> &nominals_begin, const std::vector<double> &nominals_end, const int &step, const dcm_method &dcm) const
 {
-    // create vector to hold data
-    std::vector<double> pars;
-
     // get discount factors and year fractions
     std::vector<myDate> tenor_dates = this->get_tenor_dates(tenor);
     std::vector<double> dfs = this->get_df(tenor);
+    std::vector<double> d_t = calc_period_year_fracs(tenor_dates, dcm);
+
+    // calculate par-rates
+    std::vector<double> pars(std::max(0, static_cast<int>(dfs.size()) - step));
+    calc_par_rates(dfs.data(), d_t, nominals_begin, nominals_end, step, pars.data());
+
+    // return vector of par-rates
+    return pars;
+}
+
+// get discount factors for vector of tenor integer dates in yyyymmdd format and scenarios scn_no_first, ..., scn_no_last;
+// discount factors are written into caller-provided buffer of size (scn_no_last - scn_no_first + 1) * dates.size()
+// in scenario-major order, i.e. dfs[(scn_no - scn_no_first) * dates.size() + date_idx]
+void myCurve::get_df_batch(const std::vector<int> &dates, const int &scn_no_first, const int &scn_no_last, double * dfs) const
+{
+    // number of dates
+    int dates_no = dates.size();
+    if (dates_no == 0)
+    {
+        return;
+    }
 
-    // calculate par-rate
-    double par;
-    for (int idx = 0; idx < dfs.size() - step; idx++)
+    // determine positions of tenors within the first scenario row; the positions are the same for all scenarios
+    std::vector<long> tenor_pos(dates_no);
+    for (int idx = 0; idx < dates_no; idx++)
+    {
+        tenor_pos[idx] = this->get_pos(std::tuple<int, int>(scn_no_first, dates[idx])) % this->tenors_no;
+    }
+
+    // go scenario by scenario
+    for (int scn_no = scn_no_first; scn_no <= scn_no_last; scn_no++)
     {
-        // nominals
-        par = dfs[idx] * nominals_end[idx] - dfs[idx + step] * nominals_end[idx + step];
+        double * dfs_scn = dfs + static_cast<long>(scn_no - scn_no_first) * dates_no;
 
-        double aux = 0;
-        for (int idx2 = 0; idx2 < step; idx2++)
+        // lazy curve, view or shocked scenario => evaluate curve points one by one
+        if (this->is_lazy || this->is_view || (this->shocks.count(scn_no) > 0))
         {
-            // amortizaton payments
-            double amort = nominals_begin[idx + idx2 + 1] - nominals_end[idx + idx2 + 1];
-            par -= dfs[idx + idx2 + 1] * amort;
+            for (int idx = 0; idx < dates_no; idx++)
+            {
+                dfs_scn[idx] = this->get_point(std::tuple<int, int>(scn_no, dates[idx])).df;
+            }
+        }
+        // dense curve => gather discount factors from scenario row
+        else
+        {
+            const double * df_row = this->dense->df + (this->get_pos(std::tuple<int, int>(scn_no, dates[0])) - tenor_pos[0]);
+            for (int idx = 0; idx < dates_no; idx++)
+            {
+                dfs_scn[idx] = df_row[tenor_pos[idx]];
+            }
+        }
+    }
+}
 
-            // coupon payments
-            double d_t = day_count_method(tenor_dates[idx + idx2], tenor_dates[idx + idx2 + 1], dcm);
-            aux += d_t * dfs[idx + idx2 + 1] * nominals_begin[idx + idx2 + 1];            
+// calculate forward rates between consecutive tenor integer dates in yyyymmdd format for scenarios scn_no_first, ..., scn_no_last;
+// forward rates are written into caller-provided buffer of size (scn_no_last - scn_no_first + 1) * (dates.size() - 1)
+// in scenario-major order, i.e. fwds[(scn_no - scn_no_first) * (dates.size() - 1) + date_idx]
+void myCurve::get_fwd_rate_batch(const std::vector<int> &dates, const int &scn_no_first, const int &scn_no_last, const dcm_method &dcm, double * fwds) const
+{
+    // number of dates and forward rates per scenario
+    int dates_no = dates.size();
+    int fwds_no = dates_no - 1;
+    if (fwds_no < 1)
+    {
+        return;
+    }
+
+    // year fractions between consecutive dates; they do not depend on scenario
+    std::vector<myDate> tenor_dates;
+    tenor_dates.reserve(dates_no);
+    for (int idx = 0; idx < dates_no; idx++)
+    {
+        tenor_dates.push_back(myDate(dates[idx]));
+    }
+    std::vector<double> d_t = calc_period_year_fracs(tenor_dates, dcm);
+
+    // get discount factors for all scenarios
+    std::vector<double> dfs(static_cast<long>(scn_no_last - scn_no_first + 1) * dates_no);
+    this->get_df_batch(dates, scn_no_first, scn_no_last, dfs.data());
+
+    // calculate forward rates
+    for (int scn_idx = 0; scn_idx <= scn_no_last - scn_no_first; scn_idx++)
+    {
+        const double * dfs_scn = dfs.data() + static_cast<long>(scn_idx) * dates_no;
+        double * fwds_scn = fwds + static_cast<long>(scn_idx) * fwds_no;
+        for (int idx = 0; idx < fwds_no; idx++)
+        {
+            fwds_scn[idx] = (dfs_scn[idx] / dfs_scn[idx + 1] - 1) / d_t[idx];
         }
+    }
+}
+
+// calculate par-rates of all windows of step periods over tenor integer dates in yyyymmdd format for scenarios
+// scn_no_first, ..., scn_no_last; par-rates are written into caller-provided buffer of size
+// (scn_no_last - scn_no_first + 1) * (dates.size() - step) in scenario-major order
+void myCurve::get_par_rate_batch(const std::vector<int> &dates, const int &scn_no_first, const int &scn_no_last, const std::vector<double> &nominals_begin, const std::vector<double> &nominals_end, const int &step, const dcm_method &dcm, double * pars) const
+{
+    // number of dates and par-rates per scenario
+    int dates_no = dates.size();
+    int pars_no = dates_no - step;
+    if (pars_no <= 0)
+    {
+        return;
+    }
 
-        // calculate par-rate
-        par /= aux;
+    // year fractions of periods; they do not depend on scenario
+    std::vector<myDate> tenor_dates;
+    tenor_dates.reserve(dates_no);
+    for (int idx = 0; idx < dates_no; idx++)
+    {
+        tenor_dates.push_back(myDate(dates[idx]));
+    }
+    std::vector<double> d_t = calc_period_year_fracs(tenor_dates, dcm);
+
+    // get discount factors for all scenarios
+    std::vector<double> dfs(static_cast<long>(scn_no_last - scn_no_first + 1) * dates_no);
+    this->get_df_batch(dates, scn_no_first, scn_no_last, dfs.data());
 
-        // store par-rate
-        pars.push_back(par);
+    // calculate par-rates scenario by scenario
+    for (int scn_idx = 0; scn_idx <= scn_no_last - scn_no_first; scn_idx++)
+    {
+        calc_par_rates(dfs.data() + static_cast<long>(scn_idx) * dates_no, d_t, nominals_begin, nominals_end, step, pars + static_cast<long>(scn_idx) * pars_no);
+    }
+}
+
+// add shocked scenario scn_no whose rates are rates of scenario base_scn_no shifted by shocks at given tenors in days;
+// the shocks are linearly interpolated between the tenors and kept flat beyond the first and the last tenor
+void myCurve::add_shock(const int &scn_no, const int &base_scn_no, const std::vector<double> &tenors, const std::vector<double> &shocks)
+{
+    // check shock definition
+    if ((tenors.size() != shocks.size()) || (tenors.size() == 0))
+    {
+        throw std::invalid_argument((std::string)__func__ + ": Vectors of tenors and shocks must be of the same non-zero size!");
+    }
+
+    // shocked scenario must not overwrite a loaded or another shocked scenario
+    if (((scn_no >= 0) && (scn_no < this->scn_pos.size()) && (this->scn_pos[scn_no] != -1)) || (this->shocks.count(scn_no) > 0))
+    {
+        throw std::invalid_argument((std::string)__func__ + ": Scenario " + std::to_string(scn_no) + " of curve " + this->crv_nm + " already exists!");
+    }
+
+    // base scenario must be available
+    int base_scn_no_aux = this->get_base_scn(base_scn_no);
+    if ((base_scn_no_aux < 0) || (base_scn_no_aux >= this->scn_pos.size()) || (this->scn_pos[base_scn_no_aux] == -1))
+    {
+        throw std::out_of_range((std::string)__func__ + ": Scenario " + std::to_string(base_scn_no) + " is not available for curve " + this->crv_nm + "!");
+    }
+
+    // store shock
+    this->shocks.insert(std::pair<int, crv_shock_def>(scn_no, {base_scn_no, tenors, shocks}));
+}
+
+// add shocked scenario with rates shifted in parallel
+void myCurve::add_parallel_shock(const int &scn_no, const int &base_scn_no, const double &shock)
+{
+    this->add_shock(scn_no, base_scn_no, {0.0}, {shock});
+}
+
+// add shocked scenario with rates shifted by shock_short up to tenor_short and by shock_long from tenor_long onwards;
+// the shift is linear in between
+void myCurve::add_twist_shock(const int &scn_no, const int &base_scn_no, const double &tenor_short, const double &shock_short, const double &tenor_long, const double &shock_long)
+{
+    this->add_shock(scn_no, base_scn_no, {tenor_short, tenor_long}, {shock_short, shock_long});
+}
+
+// add shocked scenario with rate bumped at key tenor key_tenors[key_idx]; the bump decreases linearly to zero at the
+// neighbouring key tenors and it is kept flat beyond the first and the last key tenor
+void myCurve::add_key_rate_shock(const int &scn_no, const int &base_scn_no, const std::vector<double> &key_tenors, const int &key_idx, const double &shock)
+{
+    // check key tenor
+    if ((key_idx < 0) || (key_idx >= key_tenors.size()))
+    {
+        throw std::out_of_range((std::string)__func__ + ": Key tenor " + std::to_string(key_idx) + " is out of range!");
+    }
+
+    // shock definition
+    std::vector<double> tenors;
+    std::vector<double> shocks;
+    if (key_idx > 0)
+    {
+        tenors.push_back(key_tenors[key_idx - 1]);
+        shocks.push_back(0.0);
+    }
+    tenors.push_back(key_tenors[key_idx]);
+    shocks.push_back(shock);
+    if (key_idx < key_tenors.size() - 1)
+    {
+        tenors.push_back(key_tenors[key_idx + 1]);
+        shocks.push_back(0.0);
+    }
+
+    // store shock
+    this->add_shock(scn_no, base_scn_no, tenors, shocks);
+}
+
+// assign object containing information on all curves; views are bound to the assigned underlying curves
+myCurves &myCurves::operator=(const myCurves &crvs)
+{
+    this->crv = crvs.crv;
+    this->bind_crvs();
+    return *this;
+}
+
+// point views on underlying curves and curve handles on curves stored within the object; handles are indices
+// of curves in order of curve names, so they are the same for copies of the object
+void myCurves::bind_crvs()
+{
+    this->crv_ptrs.clear();
+    for (std::map<std::string, myCurve>::iterator it = this->crv.begin(); it != this->crv.end(); it++)
+    {
+        if (it->second.is_view)
+        {
+            it->second.underlying_crv1 = &this->crv.at(it->second.underlying1);
+            it->second.underlying_crv2 = &this->crv.at(it->second.underlying2);
+        }
+        this->crv_ptrs.push_back(&it->second);
+    }
+}
+
+// get curve handle based on curve name; the handle is to be resolved once and used instead of curve name in
+// repeated calls
+int myCurves::get_crv_idx(const std::string &crv_nm) const
+{
+    std::map<std::string, myCurve>::const_iterator it = this->crv.find(crv_nm);
+    if (it == this->crv.end())
+    {
+        throw std::out_of_range((std::string)__func__ + ": Curve " + crv_nm + " does not exist!");
+    }
+    return std::distance(this->crv.begin(), it);
+}
+
+// get curve based on curve handle
+const myCurve &myCurves::get_crv(const int &crv_idx) const
+{
+    if ((crv_idx < 0) || (crv_idx >= this->crv_ptrs.size()))
+    {
+        throw std::out_of_range((std::string)__func__ + ": Curve handle " + std::to_string(crv_idx) + " is out of range!");
+    }
+    return *this->crv_ptrs[crv_idx];
+}
+
+// calculate hash of curve definitions, curve data and calculation date identifying binary cache file
+uint64_t myCurves::calc_cache_hash(const mySQLite &db, const std::string &sql_file_nm, const myDate &calc_date) const
+{
+    // cache file version and calculation date
+    uint64_t hash = calc_hash(std::to_string(crv_cache_version) + "\x1e" + calc_date.get_date_str() + "\x1e");
+
+    // curve definitions and curve data
+    std::string tags[2] = {"load_all_crv_def", "load_all_crv_data"};
+    for (int tag_idx = 0; tag_idx < 2; tag_idx++)
+    {
+        myDataFrame * rslt = db.query(read_sql(sql_file_nm, tags[tag_idx]));
+        for (long row_idx = 0; row_idx < rslt->tbl.values.size(); row_idx++)
+        {
+            for (int col_idx = 0; col_idx < rslt->tbl.values[row_idx].size(); col_idx++)
+            {
+                hash = calc_hash(rslt->tbl.values[row_idx][col_idx] + "\x1f", hash);
+            }
+            hash = calc_hash("\x1e", hash);
+        }
+        hash = calc_hash("\x1d", hash);
+        delete rslt;
+    }
+
+    // return hash
+    return hash;
+}
+
+// map interpolated curves from binary cache file; false is returned if the file does not exist, its version
+// or hash do not match or the file is damaged
+bool myCurves::read_cache(const std::string &cache_file_nm, const uint64_t &hash, const myDate &calc_date)
+{
+    // open file and determine its size
+    int fd = open(cache_file_nm.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        return false;
+    }
+    struct stat file_stat;
+    if ((fstat(fd, &file_stat) == -1) || (file_stat.st_size < crv_cache_header_size))
+    {
+        close(fd);
+        return false;
+    }
+    long file_size = file_stat.st_size;
+
+    // map file into memory; the mapping is private so that the file is never modified
+    void * addr = mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+    {
+        return false;
+    }
+    std::shared_ptr<void> mapping(addr, [file_size](void * ptr){munmap(ptr, file_size);});
+    const char * begin = static_cast<const char *>(addr);
+    const char * end = begin + file_size;
+    const char * cursor = begin;
+
+    // check header
+    char magic[8];
+    uint32_t version;
+    uint32_t crvs_no;
+    uint64_t hash_file;
+    uint64_t dense_begin;
+    memcpy(magic, cursor, 8);
+    cursor += 8;
+    if (!get_value(cursor, end, version) || !get_value(cursor, end, crvs_no) || !get_value(cursor, end, hash_file) ||
+        !get_value(cursor, end, dense_begin) || (memcmp(magic, crv_cache_magic, 8) != 0) || (version != crv_cache_version) ||
+        (hash_file != hash) || (dense_begin > file_size))
+    {
+        return false;
+    }
+
+    // go curve by curve
+    std::map<std::string, myCurve> crvs;
+    for (int crv_idx = 0; crv_idx < crvs_no; crv_idx++)
+    {
+        // curve definition
+        myCurve crv;
+        uint8_t is_view;
+        int32_t tenors_no;
+        int32_t scns_no;
+        if (!get_string(cursor, end, crv.crv_nm) || !get_string(cursor, end, crv.ccy_nm) || !get_string(cursor, end, crv.dcm) ||
+            !get_string(cursor, end, crv.crv_type) || !get_string(cursor, end, crv.underlying1) || !get_string(cursor, end, crv.underlying2) ||
+            !get_string(cursor, end, crv.interp) || !get_value(cursor, end, is_view) || !get_value(cursor, end, tenors_no) ||
+            !get_value(cursor, end, scns_no) || !get_vector(cursor, end, crv.scn_pos))
+        {
+            return false;
+        }
+        crv.calc_date = calc_date;
+        crv.dcm_type = get_dcm_method(crv.dcm);
+        crv.is_lazy = false;
+        crv.is_view = (is_view != 0);
+        crv.tenors_no = tenors_no;
+        crv.scns_no = scns_no;
+        crv.cache = std::make_shared<crv_cache_def>();
+
+        // curve knots
+        crv.knot_tenors.resize(scns_no);
+        crv.knot_rates.resize(scns_no);
+        for (int scn_row = 0; scn_row < scns_no; scn_row++)
+        {
+            if (!get_vector(cursor, end, crv.knot_tenors[scn_row]) || !get_vector(cursor, end, crv.knot_rates[scn_row]))
+            {
+                return false;
+            }
+        }
+        crv.calc_interps();
+
+        // dense curve storage
+        uint64_t dense_offset;
+        uint64_t dense_size;
+        long points_no = crv.is_view ? 0 : static_cast<long>(scns_no) * tenors_no;
+        if (!get_value(cursor, end, dense_offset) || !get_value(cursor, end, dense_size) || (dense_size != tenors_no + 3 * points_no) ||
+            (dense_begin + dense_offset + dense_size * sizeof(double) > file_size))
+        {
+            return false;
+        }
+        crv.dense = std::make_shared<crv_dense_def>();
+        crv.dense->mapping = mapping;
+        crv.dense->year_frac = reinterpret_cast<double *>(static_cast<char *>(addr) + dense_begin + dense_offset);
+        crv.dense->rate = crv.dense->year_frac + tenors_no;
+        crv.dense->df = crv.dense->rate + points_no;
+        crv.dense->zero_rate = crv.dense->df + points_no;
+
+        // store curve
+        crvs.insert(std::pair<std::string, myCurve>(crv.crv_nm, crv));
+    }
+
+    // curves have been restored
+    this->crv = crvs;
+    this->bind_crvs();
+    return true;
+}
+
+// write interpolated curves into binary cache file; the file is written under a temporary name and renamed
+// afterwards so that other processes never map a partially written file
+void myCurves::write_cache(const std::string &cache_file_nm, const uint64_t &hash) const
+{
+    // curve definitions, curve knots and position of dense curve storage within the dense part of the file
+    std::string meta;
+    uint64_t dense_offset = 0;
+    for (std::map<std::string, myCurve>::const_iterator it = this->crv.begin(); it != this->crv.end(); it++)
+    {
+        const myCurve &crv = it->second;
+        put_string(meta, crv.crv_nm);
+        put_string(meta, crv.ccy_nm);
+        put_string(meta, crv.dcm);
+        put_string(meta, crv.crv_type);
+        put_string(meta, crv.underlying1);
+        put_string(meta, crv.underlying2);
+        put_string(meta, crv.interp);
+        put_value<uint8_t>(meta, crv.is_view ? 1 : 0);
+        put_value<int32_t>(meta, crv.tenors_no);
+        put_value<int32_t>(meta, crv.scns_no);
+        put_vector(meta, crv.scn_pos);
+        for (int scn_row = 0; scn_row < crv.scns_no; scn_row++)
+        {
+            put_vector(meta, crv.knot_tenors[scn_row]);
+            put_vector(meta, crv.knot_rates[scn_row]);
+        }
+        long points_no = crv.is_view ? 0 : static_cast<long>(crv.scns_no) * crv.tenors_no;
+        uint64_t dense_size = crv.tenors_no + 3 * points_no;
+        put_value<uint64_t>(meta, dense_offset);
+        put_value<uint64_t>(meta, dense_size);
+        dense_offset += dense_size * sizeof(double);
+    }
+
+    // dense part of the file is aligned to size of double
+    uint64_t dense_begin = crv_cache_header_size + meta.size();
+    dense_begin = (dense_begin + sizeof(double) - 1) / sizeof(double) * sizeof(double);
+
+    // header
+    std::string header(crv_cache_magic, 8);
+    put_value<uint32_t>(header, crv_cache_version);
+    put_value<uint32_t>(header, this->crv.size());
+    put_value<uint64_t>(header, hash);
+    put_value<uint64_t>(header, dense_begin);
+
+    // open file
+    std::string tmp_file_nm = cache_file_nm + ".tmp";
+    std::ofstream f;
+    f.open(tmp_file_nm, std::ios::binary | std::ios::trunc);
+    if (!f.is_open())
+    {
+        throw std::runtime_error((std::string)__func__ + ": Unable to open file " + tmp_file_nm + "!");
+    }
+
+    // write header, curve definitions and padding
+    f.write(header.data(), header.size());
+    f.write(meta.data(), meta.size());
+    std::string padding(dense_begin - crv_cache_header_size - meta.size(), '\0');
+    f.write(padding.data(), padding.size());
+
+    // write dense curve storage curve by curve
+    for (std::map<std::string, myCurve>::const_iterator it = this->crv.begin(); it != this->crv.end(); it++)
+    {
+        const myCurve &crv = it->second;
+        long points_no = crv.is_view ? 0 : static_cast<long>(crv.scns_no) * crv.tenors_no;
+        f.write(reinterpret_cast<const char *>(crv.dense->year_frac), (crv.tenors_no + 3 * points_no) * sizeof(double));
+    }
+
+    // close file and replace the old one
+    f.close();
+    if (!f || (std::rename(tmp_file_nm.c_str(), cache_file_nm.c_str()) != 0))
+    {
+        throw std::runtime_error((std::string)__func__ + ": Unable to write file " + cache_file_nm + "!");
     }
-    
-    // return vector of forward rates
-    return pars;
 }
 
 // get year fraction based on vector of scenario numbers and tenor integer dates in yyyymmdd format
@@ -313,11 +1260,107 @@ std::vector<double> myCurves::get_df(const std::string &crv_nm, const std::vecto
 // calculate forward rate based on vector scenarios numbers and tenors
 std::vector<double> myCurves::get_fwd_rate(const std::string &crv_nm, const std::vector<std::tuple<int, int>> &tenor, const std::string &dcm) const
 {
-    return this->crv.at(crv_nm).get_fwd_rate(tenor, dcm); 
+    return this->crv.at(crv_nm).get_fwd_rate(tenor, get_dcm_method(dcm)); 
 }
 
 // calculate par rate based on vector scenarios numbers, tenors and nominals
 std::vector<double> myCurves::get_par_rate(const std::string &crv_nm, const std::vector<std::tuple<int, int>> &tenor, const std::vector<double> &nominals_begin, const std::vector<double> &nominals_end, const int &step, const std::string &dcm) const
 {
-    return this->crv.at(crv_nm).get_par_rate(tenor, nominals_begin, nominals_end, step, dcm); 
+    return this->crv.at(crv_nm).get_par_rate(tenor, nominals_begin, nominals_end, step, get_dcm_method(dcm)); 
+}
+
+// get discount factors for vector of dates and range of scenarios in scenario-major order
+void myCurves::get_df_batch(const std::string &crv_nm, const std::vector<int> &dates, const int &scn_no_first, const int &scn_no_last, double * dfs) const
+{
+    this->crv.at(crv_nm).get_df_batch(dates, scn_no_first, scn_no_last, dfs);
+}
+
+// calculate forward rates for vector of dates and range of scenarios in scenario-major order
+void myCurves::get_fwd_rate_batch(const std::string &crv_nm, const std::vector<int> &dates, const int &scn_no_first, const int &scn_no_last, const std::string &dcm, double * fwds) const
+{
+    this->crv.at(crv_nm).get_fwd_rate_batch(dates, scn_no_first, scn_no_last, get_dcm_method(dcm), fwds);
+}
+
+// add shocked scenario of a curve
+void myCurves::add_shock(const std::string &crv_nm, const int &scn_no, const int &base_scn_no, const std::vector<double> &tenors, const std::vector<double> &shocks)
+{
+    this->crv.at(crv_nm).add_shock(scn_no, base_scn_no, tenors, shocks);
+}
+
+// add shocked scenario of a curve with rates shifted in parallel
+void myCurves::add_parallel_shock(const std::string &crv_nm, const int &scn_no, const int &base_scn_no, const double &shock)
+{
+    this->crv.at(crv_nm).add_parallel_shock(scn_no, base_scn_no, shock);
+}
+
+// add shocked scenario of a curve with short and long end rates shifted by different shocks
+void myCurves::add_twist_shock(const std::string &crv_nm, const int &scn_no, const int &base_scn_no, const double &tenor_short, const double &shock_short, const double &tenor_long, const double &shock_long)
+{
+    this->crv.at(crv_nm).add_twist_shock(scn_no, base_scn_no, tenor_short, shock_short, tenor_long, shock_long);
+}
+
+// add shocked scenario of a curve with rate bumped at a key tenor
+void myCurves::add_key_rate_shock(const std::string &crv_nm, const int &scn_no, const int &base_scn_no, const std::vector<double> &key_tenors, const int &key_idx, const double &shock)
+{
+    this->crv.at(crv_nm).add_key_rate_shock(scn_no, base_scn_no, key_tenors, key_idx, shock);
+}
+
+// calculate par-rates of all windows of step periods for vector of dates and range of scenarios in scenario-major order
+void myCurves::get_par_rate_batch(const std::string &crv_nm, const std::vector<int> &dates, const int &scn_no_first, const int &scn_no_last, const std::vector<double> &nominals_begin, const std::vector<double> &nominals_end, const int &step, const std::string &dcm, double * pars) const
+{
+    this->crv.at(crv_nm).get_par_rate_batch(dates, scn_no_first, scn_no_last, nominals_begin, nominals_end, step, get_dcm_method(dcm), pars);
+}
+
+// get year fraction based on curve handle, vector of scenario numbers and tenor integer dates in yyyymmdd format
+std::vector<double> myCurves::get_year_frac(const int &crv_idx, const std::vector<std::tuple<int, int>> &tenor) const
+{
+    return this->get_crv(crv_idx).get_year_frac(tenor);
+}
+
+// get tenor dates based on curve handle, vector of scenario numbers and tenor integer dates in yyyymmdd format
+std::vector<myDate> myCurves::get_tenor_dates(const int &crv_idx, const std::vector<std::tuple<int, int>> &tenor) const
+{
+    return this->get_crv(crv_idx).get_tenor_dates(tenor);
+}
+
+// get zero rate based on curve handle, vector of scenario numbers and tenor integer dates in yyyymmdd format
+std::vector<double> myCurves::get_zero_rate(const int &crv_idx, const std::vector<std::tuple<int, int>> &tenor) const
+{
+    return this->get_crv(crv_idx).get_zero_rate(tenor);
+}
+
+// get discount factor based on curve handle, vector of scenario numbers and tenors
+std::vector<double> myCurves::get_df(const int &crv_idx, const std::vector<std::tuple<int, int>> &tenor) const
+{
+    return this->get_crv(crv_idx).get_df(tenor);
+}
+
+// calculate forward rate based on curve handle, vector scenarios numbers and tenors
+std::vector<double> myCurves::get_fwd_rate(const int &crv_idx, const std::vector<std::tuple<int, int>> &tenor, const dcm_method &dcm) const
+{
+    return this->get_crv(crv_idx).get_fwd_rate(tenor, dcm);
+}
+
+// calculate par rate based on curve handle, vector scenarios numbers, tenors and nominals
+std::vector<double> myCurves::get_par_rate(const int &crv_idx, const std::vector<std::tuple<int, int>> &tenor, const std::vector<double> &nominals_begin, const std::vector<double> &nominals_end, const int &step, const dcm_method &dcm) const
+{
+    return this->get_crv(crv_idx).get_par_rate(tenor, nominals_begin, nominals_end, step, dcm);
+}
+
+// get discount factors based on curve handle for vector of dates and range of scenarios in scenario-major order
+void myCurves::get_df_batch(const int &crv_idx, const std::vector<int> &dates, const int &scn_no_first, const int &scn_no_last, double * dfs) const
+{
+    this->get_crv(crv_idx).get_df_batch(dates, scn_no_first, scn_no_last, dfs);
+}
+
+// calculate forward rates based on curve handle for vector of dates and range of scenarios in scenario-major order
+void myCurves::get_fwd_rate_batch(const int &crv_idx, const std::vector<int> &dates, const int &scn_no_first, const int &scn_no_last, const dcm_method &dcm, double * fwds) const
+{
+    this->get_crv(crv_idx).get_fwd_rate_batch(dates, scn_no_first, scn_no_last, dcm, fwds);
+}
+
+// calculate par-rates based on curve handle for vector of dates and range of scenarios in scenario-major order
+void myCurves::get_par_rate_batch(const int &crv_idx, const std::vector<int> &dates, const int &scn_no_first, const int &scn_no_last, const std::vector<double> &nominals_begin, const std::vector<double> &nominals_end, const int &step, const dcm_method &dcm, double * pars) const
+{
+    this->get_crv(crv_idx).get_par_rate_batch(dates, scn_no_first, scn_no_last, nominals_begin, nominals_end, step, dcm, pars);
 }
@@ -153,6 +153,23 @@ int main()
         std::cout << "par rate for " + std::to_string(maturities[i]) + " - " + std::to_string(maturities[i + step]) + ": " + std::to_string(pars[i]) << std::endl;
     }
 
+    // add shocked scenario with zero parallel shift; its discount factors must be identical to the base scenario
+    // including tenors beyond the last curve knot
+    int shocked_scn_no = 1001;
+    crvs.add_parallel_shock(crv_nm, shocked_scn_no, scn_no, 0.0);
+    std::vector<std::tuple<int, int>> shocked_scn_tenors;
+    maturities.push_back(21411103);
+    scn_tenors.push_back(std::tuple<int, int>(scn_no, maturities.back()));
+    for (int i = 0; i < maturities.size(); i++)
+    {
+        shocked_scn_tenors.push_back(std::tuple<int, int>(shocked_scn_no, maturities[i]));
+    }
+    if (crvs.get_df(crv_nm, shocked_scn_tenors) != crvs.get_df(crv_nm, scn_tenors))
+    {
+        std::cout << "zero shock changed discount factors!" << std::endl;
+        return 1;
+    }
+
     // everything OK
     return 0;
 }
@@ -163,61 +180,155 @@ int main()
 #include <string>
 #include <map>
 #include <tuple>
+#include <vector>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <cstdint>
 #include "lib_sqlite.h"
 #include "lib_date.h"
+#include "fin_date.h"
+#include "fin_curve_interp.h"
 
-// tenor structure
-struct tenor_def
+// curve point derived from an interpolated rate
+struct crv_point_def
 {
-    myDate tenor_date;
-    int tenor;
-    double rate;
     double year_frac;
-    double year_frac_aux1;
-    double year_frac_aux2;
+    double rate;
     double df;
     double zero_rate;
 };
 
+// shocked scenario; rates of the base scenario are shifted at query time by a piecewise linear function of tenor
+struct crv_shock_def
+{
+    int base_scn_no; // scenario the shock is applied to; it could be another shocked scenario
+    std::vector<double> tenors; // tenors in days from calculation date; supposed to be in ascending order
+    std::vector<double> shocks; // rate shifts at the tenors; the shifts are kept flat beyond the first and the last tenor
+};
+
+// dense curve storage; shared by copies of the curve object, the values are either owned or memory mapped
+// from a binary cache file; year fractions, rates, discount factors and zero rates are stored one after another
+struct crv_dense_def
+{
+    std::vector<double> values; // owned storage
+    std::shared_ptr<void> mapping; // memory mapped binary cache file
+    double * year_frac = nullptr; // year fractions; shared by all scenarios
+    double * rate = nullptr; // interpolated rates
+    double * df = nullptr; // discount factors
+    double * zero_rate = nullptr; // zero rates
+};
+
+// cache of lazily evaluated curve points; shared by copies of the curve object
+struct crv_cache_def
+{
+    std::shared_mutex mtx;
+    std::unordered_map<long, crv_point_def> points; // map based on position within the dense curve storage
+};
+
 // define curve class
 class myCurve
 {
+    // curves could be restored from binary cache file
+    friend class myCurves;
+
+    private:
+        // object constructors; curve holding only curve knots of an underlying curve
+        myCurve(){};
+
+        // object function declarations
+        void add_scn(const int &scn_no, const std::vector<double> &tenors, const std::vector<double> &rates);
+        void load_knots(const myDataFrame &rslt);
+        void compose_knots(const myCurve &crv1, const myCurve &crv2);
+        int get_base_scn(const int &scn_no) const;
+        long get_pos(const std::tuple<int, int> &tenor) const;
+        crv_point_def get_point(const std::tuple<int, int> &tenor) const;
+
     public:
         // object variables
         myDate calc_date;
         std::string crv_nm;
         std::string ccy_nm;
         std::string dcm;
+        dcm_method dcm_type = dcm_method::undefined; // day count method resolved from dcm
         std::string crv_type;
         std::string underlying1;
         std::string underlying2;
-    
-        std::map<std::tuple<int, int>, tenor_def> tenor; // map based on scenario number and tenor date integer in yyyymmdd format
-    
+        std::string interp; // interpolation method, e.g. linear, log_linear_df, flat_fwd or monotone_cubic
+        bool is_lazy = false; // curve points are interpolated on demand rather than in constructor
+
+        // compound curve evaluated as a view; rates are summed from the underlying curves when requested
+        // and the curve holds no dense storage of rates, discount factors and zero rates
+        bool is_view = false;
+        const myCurve * underlying_crv1 = nullptr;
+        const myCurve * underlying_crv2 = nullptr;
+
+        // curve knots as loaded from the database or composed from the underlying curves; indexed by scenario row
+        std::vector<std::vector<double>> knot_tenors;
+        std::vector<std::vector<double>> knot_rates;
+        std::vector<myCurveInterp> interps; // interpolation objects; indexed by scenario row
+
+        // dense curve storage; tenor of n days from calculation date is stored at position n - 1
+        // of each scenario row, scenario rows are stored one after another (scenario-major order);
+        // the storage is not allocated for a lazy curve and a view holds year fractions only
+        int tenors_no = 0; // number of daily tenors per scenario
+        int scns_no = 0; // number of stored scenarios
+        std::vector<int> scn_pos; // row of scenario in the dense storage; indexed by scenario number, -1 for missing scenario
+        std::shared_ptr<crv_dense_def> dense;
+
+        // shocked scenarios; map based on shocked scenario number
+        std::map<int, crv_shock_def> shocks;
+
+        // curve points of a lazy curve evaluated so far
+        std::shared_ptr<crv_cache_def> cache;
+
         // object constructors
-        myCurve(const mySQLite &db, const std::string &sql_file_nm, const std::string &crv_nm, const myDate &calc_date);
+        myCurve(const mySQLite &db, const std::string &sql_file_nm, const std::string &crv_nm, const myDate &calc_date, const bool &is_lazy = false, const int &threads_no = 1, const std::map<std::string, myCurve> * crvs = nullptr);
 
         // object destructors
         ~myCurve(){};
 
         // object function declarations
+        bool is_view_of(const myCurve &crv1, const myCurve &crv2) const;
+        void calc_interps();
+        void alloc_dense();
+        void calc_scns(const int &scn_row_first, const int &scn_row_last);
         std::vector<double> get_year_frac(const std::vector<std::tuple<int, int>> &tenor) const;
         std::vector<myDate> get_tenor_dates(const std::vector<std::tuple<int, int>> &tenor) const;
         std::vector<double> get_zero_rate(const std::vector<std::tuple<int, int>> &tenor) const;
         std::vector<double> get_df(const std::vector<std::tuple<int, int>> &tenor) const;
-        std::vector<double> get_fwd_rate(const std::vector<std::tuple<int, int>> &tenor, const std::string &dcm) const;
-        std::vector<double> get_par_rate(const std::vector<std::tuple<int, int>> &tenor, const std::vector<double> &nominals, const std::vector<double> &amorts, const int &step, const std::string &dcm) const;
+        std::vector<double> get_fwd_rate(const std::vector<std::tuple<int, int>> &tenor, const dcm_method &dcm) const;
+        std::vector<double> get_par_rate(const std::vector<std::tuple<int, int>> &tenor, const std::vector<double> &nominals, const std::vector<double> &amorts, const int &step, const dcm_method &dcm) const;
+        void get_df_batch(const std::vector<int> &dates, const int &scn_no_first, const int &scn_no_last, double * dfs) const;
+        void get_fwd_rate_batch(const std::vector<int> &dates, const int &scn_no_first, const int &scn_no_last, const dcm_method &dcm, double * fwds) const;
+        void get_par_rate_batch(const std::vector<int> &dates, const int &scn_no_first, const int &scn_no_last, const std::vector<double> &nominals_begin, const std::vector<double> &nominals_end, const int &step, const dcm_method &dcm, double * pars) const;
+        void add_shock(const int &scn_no, const int &base_scn_no, const std::vector<double> &tenors, const std::vector<double> &shocks);
+        void add_parallel_shock(const int &scn_no, const int &base_scn_no, const double &shock);
+        void add_twist_shock(const int &scn_no, const int &base_scn_no, const double &tenor_short, const double &shock_short, const double &tenor_long, const double &shock_long);
+        void add_key_rate_shock(const int &scn_no, const int &base_scn_no, const std::vector<double> &key_tenors, const int &key_idx, const double &shock);
 };
 
 // define curves class
 class myCurves
 {
+    private:
+        // object variables
+        std::vector<myCurve *> crv_ptrs; // curves indexed by curve handle
+
+        // object function declarations
+        void bind_crvs();
+        uint64_t calc_cache_hash(const mySQLite &db, const std::string &sql_file_nm, const myDate &calc_date) const;
+        bool read_cache(const std::string &cache_file_nm, const uint64_t &hash, const myDate &calc_date);
+        void write_cache(const std::string &cache_file_nm, const uint64_t &hash) const;
+
     public:
         // object variables
         std::map<std::string, myCurve> crv; // map based on curve name
 
         // object constructors
-        myCurves(const mySQLite &db, const std::string &sql_file_nm, const myDate &calc_date);
+        myCurves(const mySQLite &db, const std::string &sql_file_nm, const myDate &calc_date, const bool &is_lazy = false, const int &threads_no = 1, const std::string &cache_file_nm = "");
+        myCurves(const myCurves &crvs);
+        myCurves &operator=(const myCurves &crvs);
 
         // object destructors
         ~myCurves(){};
@@ -229,4 +340,22 @@ class myCurves
         std::vector<double> get_df(const std::string &crv_nm, const std::vector<std::tuple<int, int>> &tenor) const;
         std::vector<double> get_fwd_rate(const std::string &crv_nm, const std::vector<std::tuple<int, int>> &tenor, const std::string &dcm) const;
         std::vector<double> get_par_rate(const std::string &crv_nm, const std::vector<std::tuple<int, int>> &tenor, const std::vector<double> &nominals, const std::vector<double> &amorts, const int &step, const std::string &dcm) const;
+        void get_df_batch(const std::string &crv_nm, const std::vector<int> &dates, const int &scn_no_first, const int &scn_no_last, double * dfs) const;
+        void get_fwd_rate_batch(const std::string &crv_nm, const std::vector<int> &dates, const int &scn_no_first, const int &scn_no_last, const std::string &dcm, double * fwds) const;
+        void get_par_rate_batch(const std::string &crv_nm, const std::vector<int> &dates, const int &scn_no_first, const int &scn_no_last, const std::vector<double> &nominals_begin, const std::vector<double> &nominals_end, const int &step, const std::string &dcm, double * pars) const;
+        int get_crv_idx(const std::string &crv_nm) const;
+        const myCurve &get_crv(const int &crv_idx) const;
+        std::vector<double> get_year_frac(const int &crv_idx, const std::vector<std::tuple<int, int>> &tenor) const;
+        std::vector<myDate> get_tenor_dates(const int &crv_idx, const std::vector<std::tuple<int, int>> &tenor) const;
+        std::vector<double> get_zero_rate(const int &crv_idx, const std::vector<std::tuple<int, int>> &tenor) const;
+        std::vector<double> get_df(const int &crv_idx, const std::vector<std::tuple<int, int>> &tenor) const;
+        std::vector<double> get_fwd_rate(const int &crv_idx, const std::vector<std::tuple<int, int>> &tenor, const dcm_method &dcm) const;
+        std::vector<double> get_par_rate(const int &crv_idx, const std::vector<std::tuple<int, int>> &tenor, const std::vector<double> &nominals, const std::vector<double> &amorts, const int &step, const dcm_method &dcm) const;
+        void get_df_batch(const int &crv_idx, const std::vector<int> &dates, const int &scn_no_first, const int &scn_no_last, double * dfs) const;
+        void get_fwd_rate_batch(const int &crv_idx, const std::vector<int> &dates, const int &scn_no_first, const int &scn_no_last, const dcm_method &dcm, double * fwds) const;
+        void get_par_rate_batch(const int &crv_idx, const std::vector<int> &dates, const int &scn_no_first, const int &scn_no_last, const std::vector<double> &nominals_begin, const std::vector<double> &nominals_end, const int &step, const dcm_method &dcm, double * pars) const;
+        void add_shock(const std::string &crv_nm, const int &scn_no, const int &base_scn_no, const std::vector<double> &tenors, const std::vector<double> &shocks);
+        void add_parallel_shock(const std::string &crv_nm, const int &scn_no, const int &base_scn_no, const double &shock);
+        void add_twist_shock(const std::string &crv_nm, const int &scn_no, const int &base_scn_no, const double &tenor_short, const double &shock_short, const double &tenor_long, const double &shock_long);
+        void add_key_rate_shock(const std::string &crv_nm, const int &scn_no, const int &base_scn_no, const std::vector<double> &key_tenors, const int &key_idx, const double &shock);
 };
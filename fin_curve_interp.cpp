@@ -0,0 +1,289 @@
+#include <string>
+#include <vector>
+#include <math.h>
+#include <algorithm>
+#include <stdexcept>
+#include "lib_math.h"
+#include "fin_curve_interp.h"
+
+/*
+ * AUXILIARY FUNCTIONS
+ */
+
+// translate interpolation method name into interpolation method
+crv_interp_method get_crv_interp_method(const std::string &interp_nm)
+{
+    if (interp_nm.compare("linear") == 0)
+    {
+        return crv_interp_method::linear;
+    }
+    // flat forward rates are equivalent to linear interpolation of log discount factors
+    else if ((interp_nm.compare("log_linear_df") == 0) || (interp_nm.compare("flat_fwd") == 0))
+    {
+        return crv_interp_method::log_linear_df;
+    }
+    else if (interp_nm.compare("monotone_cubic") == 0)
+    {
+        return crv_interp_method::monotone_cubic;
+    }
+    else
+    {
+        throw std::invalid_argument((std::string)__func__ + ": " + interp_nm + " is not a supported interpolation method!");
+    }
+}
+
+// calculate discount factors and zero rates for a batch of rates and year fractions; the calculation is done in
+// logarithms with branch-free kernels of lib_math so that the loop can be vectorized
+void calc_df_zero_rate(const double * rate, const double * year_frac, double * df, double * zero_rate, const int &values_no)
+{
+    for (int idx = 0; idx < values_no; idx++)
+    {
+        // split year fraction into whole years and the remaining fraction of a year
+        double year_frac_aux2 = fast_floor(year_frac[idx]);
+        double year_frac_aux1 = year_frac[idx] - year_frac_aux2;
+
+        // calculate discount factor
+        double log_df = -fast_log(1 + rate[idx] * year_frac_aux1) - year_frac_aux2 * fast_log(1 + rate[idx]);
+        df[idx] = fast_exp(log_df);
+
+        // calculate zero rate; it is zero for zero year fraction
+        zero_rate[idx] = select_if_negative(0. - fabs(year_frac[idx]), fast_exp(-log_df / year_frac[idx]) - 1, 0.);
+    }
+}
+
+// calculate discount factor and zero rate from rate and year fraction
+void calc_df_zero_rate(const double &rate, const double &year_frac, double &df, double &zero_rate)
+{
+    calc_df_zero_rate(&rate, &year_frac, &df, &zero_rate, 1);
+}
+
+// calculate discount factor and zero rate from rate and year fraction consistently with interpolation method;
+// rates of curves with interpolated log discount factors are zero rates
+void calc_df_zero_rate(const crv_interp_method &method, const double &rate, const double &year_frac, double &df, double &zero_rate)
+{
+    if (method == crv_interp_method::log_linear_df)
+    {
+        zero_rate = rate;
+        df = fast_pow(1 + rate, -year_frac);
+    }
+    else
+    {
+        calc_df_zero_rate(rate, year_frac, df, zero_rate);
+    }
+}
+
+/*
+ * OBJECT CONSTRUCTORS
+ */
+
+// interpolation of a single curve scenario
+myCurveInterp::myCurveInterp(const std::string &interp_nm, const std::vector<double> &tenors, const std::vector<double> &rates, const std::vector<double> &year_fracs)
+{
+    // tenors are supposed to be ordered in ascending order; the assumption is not checked
+    this->method = get_crv_interp_method(interp_nm);
+    this->tenors = tenors;
+    this->rates = rates;
+    this->year_fracs = year_fracs;
+
+    // check that there is one rate and one year fraction for each tenor
+    if ((this->tenors.size() != this->rates.size()) || (this->tenors.size() != this->year_fracs.size()))
+    {
+        throw std::invalid_argument((std::string)__func__ + ": Vectors of tenors, rates and year fractions must be of the same size!");
+    }
+    if (this->tenors.size() == 0)
+    {
+        throw std::invalid_argument((std::string)__func__ + ": At least one curve knot is required!");
+    }
+
+    // calculate coefficients segment by segment
+    int segments_no = this->tenors.size() - 1;
+    this->coefs.assign(4 * segments_no, 0.0);
+    this->extrap_rates[0] = this->rates[0];
+    this->extrap_rates[1] = this->rates[segments_no];
+
+    // linear interpolation of rates
+    if (this->method == crv_interp_method::linear)
+    {
+        for (int idx = 0; idx < segments_no; idx++)
+        {
+            this->coefs[4 * idx] = this->rates[idx];
+            this->coefs[4 * idx + 1] = (this->rates[idx + 1] - this->rates[idx]) / (this->tenors[idx + 1] - this->tenors[idx]);
+        }
+    }
+    // linear interpolation of log discount factors in year fraction
+    else if (this->method == crv_interp_method::log_linear_df)
+    {
+        // log discount factors and zero rates of curve knots
+        std::vector<double> log_dfs(this->tenors.size(), 0.0);
+        std::vector<double> zero_rates(this->rates);
+        for (int idx = 0; idx < this->tenors.size(); idx++)
+        {
+            if (this->year_fracs[idx] > 0)
+            {
+                double df;
+                calc_df_zero_rate(this->rates[idx], this->year_fracs[idx], df, zero_rates[idx]);
+                log_dfs[idx] = log(df);
+            }
+        }
+
+        // rates of these curves are zero rates, hence zero rates are kept flat beyond the curve knots as well
+        this->extrap_rates[0] = zero_rates[0];
+        this->extrap_rates[1] = zero_rates[segments_no];
+
+        // constant instantaneous forward rate within each segment
+        for (int idx = 0; idx < segments_no; idx++)
+        {
+            this->coefs[4 * idx] = log_dfs[idx];
+            this->coefs[4 * idx + 1] = (log_dfs[idx + 1] - log_dfs[idx]) / (this->year_fracs[idx + 1] - this->year_fracs[idx]);
+        }
+    }
+    // monotone cubic interpolation of rates
+    else if (this->method == crv_interp_method::monotone_cubic)
+    {
+        // secant slopes of individual segments
+        std::vector<double> deltas(segments_no);
+        for (int idx = 0; idx < segments_no; idx++)
+        {
+            deltas[idx] = (this->rates[idx + 1] - this->rates[idx]) / (this->tenors[idx + 1] - this->tenors[idx]);
+        }
+
+        // initial tangents at curve knots
+        std::vector<double> slopes(this->tenors.size(), 0.0);
+        if (segments_no > 0)
+        {
+            slopes[0] = deltas[0];
+            slopes[segments_no] = deltas[segments_no - 1];
+        }
+        for (int idx = 1; idx < segments_no; idx++)
+        {
+            slopes[idx] = (deltas[idx - 1] * deltas[idx] <= 0) ? 0.0 : (deltas[idx - 1] + deltas[idx]) / 2;
+        }
+
+        // limit tangents to preserve monotonicity (Fritsch-Carlson)
+        for (int idx = 0; idx < segments_no; idx++)
+        {
+            if (deltas[idx] == 0)
+            {
+                slopes[idx] = 0.0;
+                slopes[idx + 1] = 0.0;
+                continue;
+            }
+            double alpha = slopes[idx] / deltas[idx];
+            double beta = slopes[idx + 1] / deltas[idx];
+            double dist = alpha * alpha + beta * beta;
+            if (dist > 9)
+            {
+                double tau = 3. / sqrt(dist);
+                slopes[idx] = tau * alpha * deltas[idx];
+                slopes[idx + 1] = tau * beta * deltas[idx];
+            }
+        }
+
+        // cubic Hermite polynomial coefficients
+        for (int idx = 0; idx < segments_no; idx++)
+        {
+            double h = this->tenors[idx + 1] - this->tenors[idx];
+            this->coefs[4 * idx] = this->rates[idx];
+            this->coefs[4 * idx + 1] = slopes[idx];
+            this->coefs[4 * idx + 2] = (3 * deltas[idx] - 2 * slopes[idx] - slopes[idx + 1]) / h;
+            this->coefs[4 * idx + 3] = (slopes[idx] + slopes[idx + 1] - 2 * deltas[idx]) / (h * h);
+        }
+    }
+}
+
+/*
+ * OBJECT FUNCTIONS
+ */
+
+// find segment containing tenor; -1 stands for tenors up to the first curve knot and the number of segments
+// for tenors from the last curve knot onwards
+int myCurveInterp::find_segment(const double &tenor) const
+{
+    int segments_no = this->tenors.size() - 1;
+    if (tenor <= this->tenors[0])
+    {
+        return -1;
+    }
+    else if (tenor >= this->tenors[segments_no])
+    {
+        return segments_no;
+    }
+    return std::upper_bound(this->tenors.begin(), this->tenors.end(), tenor) - this->tenors.begin() - 1;
+}
+
+// evaluate rate within a given segment; it is not used for interior segments of curves with interpolated log
+// discount factors
+double myCurveInterp::eval_rate(const int &segment, const double &tenor) const
+{
+    // rates are kept flat beyond the first and the last curve knot
+    if ((segment < 0) || (segment >= this->tenors.size() - 1))
+    {
+        return (segment < 0) ? this->extrap_rates[0] : this->extrap_rates[1];
+    }
+
+    // segment coefficients
+    const double * coef = this->coefs.data() + 4 * segment;
+
+    // linear interpolation of rates
+    if (this->method == crv_interp_method::linear)
+    {
+        return coef[0] + coef[1] * (tenor - this->tenors[segment]);
+    }
+    // monotone cubic interpolation of rates
+    double dx = tenor - this->tenors[segment];
+    return coef[0] + dx * (coef[1] + dx * (coef[2] + dx * coef[3]));
+}
+
+// evaluate curve within a given segment
+void myCurveInterp::eval_segment(const int &segment, const double &tenor, const double &year_frac, double &rate, double &df, double &zero_rate) const
+{
+    // linear interpolation of log discount factors within curve knots; rate is expressed as zero rate
+    if ((this->method == crv_interp_method::log_linear_df) && (segment >= 0) && (segment < this->tenors.size() - 1))
+    {
+        const double * coef = this->coefs.data() + 4 * segment;
+        df = fast_exp(coef[0] + coef[1] * (year_frac - this->year_fracs[segment]));
+        zero_rate = fast_pow(df, -1. / year_frac) - 1;
+        rate = zero_rate;
+        return;
+    }
+
+    // interpolation of rates; flat zero rates beyond curve knots of curves with interpolated log discount factors
+    rate = this->eval_rate(segment, tenor);
+    calc_df_zero_rate(this->method, rate, year_frac, df, zero_rate);
+}
+
+// evaluate curve at a single tenor expressed in days together with its year fraction
+void myCurveInterp::eval(const double &tenor, const double &year_frac, double &rate, double &df, double &zero_rate) const
+{
+    this->eval_segment(this->find_segment(tenor), tenor, year_frac, rate, df, zero_rate);
+}
+
+// evaluate curve at consecutive daily tenors tenor_first, ..., tenor_last; year fractions of the tenors are
+// taken from year_frac and results are written into caller-provided buffers, all indexed from zero
+void myCurveInterp::eval(const int &tenor_first, const int &tenor_last, const double * year_frac, double * rate, double * df, double * zero_rate) const
+{
+    // the segment is only moved forward as the tenors are increasing
+    int segments_no = this->tenors.size() - 1;
+    int segment = this->find_segment(tenor_first);
+    for (int tenor = tenor_first, idx = 0; tenor <= tenor_last; tenor++, idx++)
+    {
+        while ((segment < segments_no) && ((segment < 0) ? (tenor > this->tenors[0]) : (tenor >= this->tenors[segment + 1])))
+        {
+            segment++;
+        }
+        if (this->method == crv_interp_method::log_linear_df)
+        {
+            this->eval_segment(segment, tenor, year_frac[idx], rate[idx], df[idx], zero_rate[idx]);
+        }
+        else
+        {
+            rate[idx] = this->eval_rate(segment, tenor);
+        }
+    }
+
+    // discount factors and zero rates of interpolated rates are calculated in one batch
+    if (this->method != crv_interp_method::log_linear_df)
+    {
+        calc_df_zero_rate(rate, year_frac, df, zero_rate, tenor_last - tenor_first + 1);
+    }
+}
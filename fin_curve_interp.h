@@ -0,0 +1,77 @@
+#pragma once
+
+/*
+#include <string>
+#include <iostream>
+#include <vector>
+#include "fin_curve_interp.h"
+
+int main()
+{
+    // curve knots; tenors are expressed in days from calculation date
+    std::vector<double> tenors = {1, 30, 365, 730, 1825};
+    std::vector<double> rates = {0.001, 0.002, 0.005, 0.008, 0.012};
+    std::vector<double> year_fracs = {1. / 365, 30. / 365, 1., 2., 5.};
+
+    // create interpolation object; the coefficients are calculated only once
+    myCurveInterp interp = myCurveInterp("monotone_cubic", tenors, rates, year_fracs);
+
+    // evaluate curve at a single tenor
+    double rate, df, zero_rate;
+    interp.eval(500, 500. / 365, rate, df, zero_rate);
+    std::cout << "rate: " << rate << ", discount factor: " << df << ", zero rate: " << zero_rate << std::endl;
+
+    // everything OK
+    return 0;
+}
+*/
+
+#include <string>
+#include <vector>
+
+// supported curve interpolation methods
+enum class crv_interp_method
+{
+    linear, // linear interpolation of rates
+    log_linear_df, // linear interpolation of log discount factors, i.e. flat forward rates
+    monotone_cubic // monotone cubic (Fritsch-Carlson) interpolation of rates
+};
+
+// translate interpolation method name into interpolation method
+crv_interp_method get_crv_interp_method(const std::string &interp_nm);
+
+// calculate discount factor and zero rate from rate and year fraction
+void calc_df_zero_rate(const double &rate, const double &year_frac, double &df, double &zero_rate);
+void calc_df_zero_rate(const crv_interp_method &method, const double &rate, const double &year_frac, double &df, double &zero_rate);
+void calc_df_zero_rate(const double * rate, const double * year_frac, double * df, double * zero_rate, const int &values_no);
+
+// define object that interpolates a single curve scenario; coefficients of individual segments between
+// curve knots are calculated in constructor so that evaluation is a segment search and a short polynomial
+class myCurveInterp
+{
+    private:
+        // variables
+        crv_interp_method method;
+        std::vector<double> tenors; // tenors of curve knots in days; supposed to be in ascending order
+        std::vector<double> year_fracs; // year fractions of curve knots
+        std::vector<double> rates; // rates of curve knots
+        std::vector<double> coefs; // four polynomial coefficients per segment
+        double extrap_rates[2]; // rates kept flat below the first and above the last curve knot
+
+        // object function declarations
+        int find_segment(const double &tenor) const;
+        double eval_rate(const int &segment, const double &tenor) const;
+        void eval_segment(const int &segment, const double &tenor, const double &year_frac, double &rate, double &df, double &zero_rate) const;
+
+    public:
+        // object constructors
+        myCurveInterp(const std::string &interp_nm, const std::vector<double> &tenors, const std::vector<double> &rates, const std::vector<double> &year_fracs);
+
+        // object destructor
+        ~myCurveInterp(){};
+
+        // object function declarations
+        crv_interp_method get_method() const {return this->method;};
+        void eval(const double &tenor, const double &year_frac, double &rate, double &df, double &zero_rate) const;
+        void eval(const int &tenor_first, const int &tenor_last, const double * year_frac, double * rate, double * df, double * zero_rate) const;
+};
@@ -1,46 +1,39 @@
 #include <string>
 #include <algorithm>
+#include <map>
+#include <vector>
+#include <mutex>
+#include <shared_mutex>
+#include "lib_sqlite.h"
 #include "fin_date.h"
 
 // calculate year fractions for family of 30/360 methods
-double calc_year_fraction(const int &day1, const int &month1, const int &year1, const int &day2, const int &month2, const int &year2)
+static inline double calc_year_fraction(const int &day1, const int &month1, const int &year1, const int &day2, const int &month2, const int &year2)
 {
         // calculate year fraction
         return (360. * (year2 - year1) + 30. * (month2 - month1) + (day2 - day1)) / 360.;
 }
 
-// implementation of day count method; see https://en.wikipedia.org/wiki/Day_count_convention
-double day_count_method(const myDate &date1, const myDate &date2, const std::string &dcm)
+// implementation of a single day count method; see https://en.wikipedia.org/wiki/Day_count_convention
+template <dcm_method dcm>
+static inline double calc_year_fraction(const myDate &date1, const myDate &date2)
 {
-    // variables
-    int day1;
-    int day2;
-    int month1;
-    int month2;
-    int year1;
-    int year2;
-    double year_fraction;
-    bool last_february_day1;
-    bool last_february_day2;
-
     // check that date1 preceeds date2
     if (date1.get_days_no() >= date2.get_days_no())
     {
         throw std::invalid_argument((std::string)__func__ + ": Parameter date1 must preceed date2!");
     }
 
-    // extract day, month and year from date 1
-    day1 = date1.get_day();
-    month1 = date1.get_month();
-    year1 = date1.get_year();
-
-    // extract day, month and year from date 2
-    day2 = date2.get_day();
-    month2 = date2.get_month();
-    year2 = date2.get_year();
+    // extract day, month and year from date 1 and date 2
+    int day1 = date1.get_day();
+    int month1 = date1.get_month();
+    int year1 = date1.get_year();
+    int day2 = date2.get_day();
+    int month2 = date2.get_month();
+    int year2 = date2.get_year();
 
     // 30/360 bond basis
-    if (dcm.compare("30_360") == 0)
+    if constexpr (dcm == dcm_method::thirty_360)
     {
         // adjust day1
         day1 = std::min(day1, 30);
@@ -52,31 +45,14 @@ double day_count_method(const myDate &date1, const myDate &date2, const std::str
         }
 
         // calculate year fraction
-        year_fraction = calc_year_fraction(day1, month1, year1, day2, month2, year2);
+        return calc_year_fraction(day1, month1, year1, day2, month2, year2);
     }
     // 30/360 US
-    else if (dcm.compare("30US_360") == 0)
+    else if constexpr (dcm == dcm_method::thirty_us_360)
     {
-
-        // determine if date1 is the last February day
-        if ((month1 == 2) and date1.is_last_day_in_month())
-        {
-            last_february_day1 = true;
-        }
-        else
-        {
-            last_february_day1 = false;
-        }
-
-        // determine if date2 is the last February day
-        if ((month2 == 2) and date2.is_last_day_in_month())
-        {
-            last_february_day2 = true;
-        }
-        else
-        {
-            last_february_day2 = false;
-        }
+        // determine if date1 and date2 are the last February days
+        bool last_february_day1 = (month1 == 2) && date1.is_last_day_in_month();
+        bool last_february_day2 = (month2 == 2) && date2.is_last_day_in_month();
 
         // adjust day2 if both date1 and date2 are the last February days
         if (last_february_day1 && last_february_day2)
@@ -103,81 +79,251 @@ double day_count_method(const myDate &date1, const myDate &date2, const std::str
         }
 
         // calculate year fraction
-        year_fraction = calc_year_fraction(day1, month1, year1, day2, month2, year2);
+        return calc_year_fraction(day1, month1, year1, day2, month2, year2);
     }
     // actual / 360 method
-    else if (dcm.compare("ACT_360") == 0)
+    else if constexpr (dcm == dcm_method::act_360)
     {
-        // calculate year fraction
-        year_fraction = (date2.get_days_no() - date1.get_days_no()) / 360.;
+        return (date2.get_days_no() - date1.get_days_no()) / 360.;
     }
     // actual / 365 method
-    else if (dcm.compare("ACT_365") == 0)
+    else if constexpr (dcm == dcm_method::act_365)
     {
-        // calculate year fraction
-        year_fraction = (date2.get_days_no() - date1.get_days_no()) / 365.;
+        return (date2.get_days_no() - date1.get_days_no()) / 365.;
     }
     // actual / actual ISDA method
-    else if (dcm.compare("ACT_ACT") == 0)
+    else
     {
+        // days in years of date1 and date2
+        double days_in_year1 = date1.is_leap_year() ? 366. : 365.;
+        double days_in_year2 = date2.is_leap_year() ? 366. : 365.;
+
         // date1 and date2 fall into the same year
         if (year1 == year2)
         {
-            // the year is a leap year
-            if (date1.is_leap_year())
-            {
-                // calculate year fraction
-                year_fraction = (date2.get_days_no() - date1.get_days_no()) / 366.;           
-            }
-            else
-            {
-                // calculate year fraction
-                year_fraction = (date2.get_days_no() - date1.get_days_no()) / 365.; 
-            }
+            return (date2.get_days_no() - date1.get_days_no()) / days_in_year1;
         }
-        // date1 and date2 fall into different years
-        else
-        {   
-            // auxiliary variables
-            double year_fraction1_aux;
-            double year_fraction2_aux;
-
-            // create auxiliary dates
-            myDate date1_aux = myDate(date1.get_year() * 10000 + 1231);
-            myDate date2_aux = myDate(date2.get_year() * 10000 + 0101);
-
-            // calculate the first auxiliary year fraction
-            year_fraction1_aux = date1_aux.get_days_no() - date1.get_days_no();
-            if (date1.is_leap_year())
-            {
-                year_fraction1_aux /= 366;
-            }
-            else
-            {
-                year_fraction1_aux /= 365;
-            }
 
-            // calculate the seconds auxiliary year fraction
-            year_fraction2_aux = date2.get_days_no() - date2_aux.get_days_no();
-            if (date2.is_leap_year())
-            {
-                year_fraction2_aux /= 366;
-            }
-            else
-            {
-                year_fraction2_aux /= 365;
-            }
+        // date1 and date2 fall into different years; year fractions till the end of year1, from the
+        // beginning of year2 and whole years in between
+        double year_fraction1_aux = (calc_days_no(year1, 12, 31) - date1.get_days_no()) / days_in_year1;
+        double year_fraction2_aux = (date2.get_days_no() - calc_days_no(year2, 1, 1)) / days_in_year2;
+        return year_fraction1_aux + year_fraction2_aux + (year2 - year1 - 1);
+    }
+}
 
-            // calculate the final year fraction
-            year_fraction = year_fraction1_aux + year_fraction2_aux + (date2.get_year() - date1.get_year() - 1);
-        }
+// calculate year fractions of date pairs for a single day count method
+template <dcm_method dcm>
+static void calc_year_fractions(const myDate * dates_begin, const int &dates_begin_step, const myDate * dates_end, const int &dates_no, double * year_fracs)
+{
+    for (int idx = 0; idx < dates_no; idx++)
+    {
+        year_fracs[idx] = calc_year_fraction<dcm>(dates_begin[idx * dates_begin_step], dates_end[idx]);
+    }
+}
+
+// dispatch calculation of year fractions to implementation of a given day count method
+static void calc_year_fractions(const myDate * dates_begin, const int &dates_begin_step, const myDate * dates_end, const int &dates_no, const dcm_method &dcm, double * year_fracs)
+{
+    switch (dcm)
+    {
+        case dcm_method::thirty_360:
+            calc_year_fractions<dcm_method::thirty_360>(dates_begin, dates_begin_step, dates_end, dates_no, year_fracs);
+            break;
+        case dcm_method::thirty_us_360:
+            calc_year_fractions<dcm_method::thirty_us_360>(dates_begin, dates_begin_step, dates_end, dates_no, year_fracs);
+            break;
+        case dcm_method::act_360:
+            calc_year_fractions<dcm_method::act_360>(dates_begin, dates_begin_step, dates_end, dates_no, year_fracs);
+            break;
+        case dcm_method::act_365:
+            calc_year_fractions<dcm_method::act_365>(dates_begin, dates_begin_step, dates_end, dates_no, year_fracs);
+            break;
+        case dcm_method::act_act:
+            calc_year_fractions<dcm_method::act_act>(dates_begin, dates_begin_step, dates_end, dates_no, year_fracs);
+            break;
+        default:
+            throw std::invalid_argument((std::string)__func__ + ": Day count method is not defined!");
+    }
+}
+
+// translate day count method name into day count method; missing day count method is translated into
+// undefined day count method, which fails only when year fraction is calculated
+dcm_method get_dcm_method(const std::string &dcm)
+{
+    if (dcm.compare("") == 0)
+    {
+        return dcm_method::undefined;
+    }
+    else if (dcm.compare("30_360") == 0)
+    {
+        return dcm_method::thirty_360;
+    }
+    else if (dcm.compare("30US_360") == 0)
+    {
+        return dcm_method::thirty_us_360;
+    }
+    else if (dcm.compare("ACT_360") == 0)
+    {
+        return dcm_method::act_360;
+    }
+    else if (dcm.compare("ACT_365") == 0)
+    {
+        return dcm_method::act_365;
+    }
+    else if (dcm.compare("ACT_ACT") == 0)
+    {
+        return dcm_method::act_act;
     }
-    // supported day count method
     else
     {
         throw std::invalid_argument((std::string)__func__ + ": " + dcm + " is not a supported day count method!");
     }
+}
 
-    // return calcualted year fraction
+// implementation of day count method; see https://en.wikipedia.org/wiki/Day_count_convention
+double day_count_method(const myDate &date1, const myDate &date2, const dcm_method &dcm)
+{
+    double year_fraction;
+    calc_year_fractions(&date1, 0, &date2, 1, dcm, &year_fraction);
     return year_fraction;
 }
+
+// implementation of day count method given by its name
+double day_count_method(const myDate &date1, const myDate &date2, const std::string &dcm)
+{
+    return day_count_method(date1, date2, get_dcm_method(dcm));
+}
+
+// calculate year fractions between pairs of begin and end dates; year fractions are written into caller-provided
+// buffer of the same size as vectors of dates
+void year_fractions(const std::vector<myDate> &dates_begin, const std::vector<myDate> &dates_end, const dcm_method &dcm, double * year_fracs)
+{
+    // check that there is one begin date for each end date
+    if (dates_begin.size() != dates_end.size())
+    {
+        throw std::invalid_argument((std::string)__func__ + ": Vectors of begin and end dates must be of the same size!");
+    }
+    calc_year_fractions(dates_begin.data(), 1, dates_end.data(), dates_end.size(), dcm, year_fracs);
+}
+
+// calculate year fractions between a common begin date and end dates; year fractions are written into caller-provided
+// buffer of the same size as vector of end dates
+void year_fractions(const myDate &date_begin, const std::vector<myDate> &dates_end, const dcm_method &dcm, double * year_fracs)
+{
+    calc_year_fractions(&date_begin, 0, dates_end.data(), dates_end.size(), dcm, year_fracs);
+}
+
+// resolve holiday calendar and business day convention used to adjust schedule of a contract; contract without
+// calendar keeps unadjusted schedule and missing convention defaults to modified following
+const myCalendar * get_schedule_cal(const myCalendars * cals, const std::string &cal_nm, const std::string &conv_nm, bday_conv &conv, std::string &wrn_msg)
+{
+    // calendar not provided
+    conv = bday_conv::unadjusted;
+    if (cal_nm.compare("") == 0)
+    {
+        if (conv_nm.compare("") != 0)
+        {
+            wrn_msg += "business day convention provided without holiday calendar;";
+        }
+        return nullptr;
+    }
+
+    // calendars not loaded
+    if (cals == nullptr)
+    {
+        wrn_msg += "holiday calendars not loaded, schedule is not adjusted to calendar " + cal_nm + ";";
+        return nullptr;
+    }
+
+    // business day convention
+    conv = (conv_nm.compare("") == 0) ? bday_conv::modified_following : get_bday_conv(conv_nm);
+    return &cals->get_cal(cal_nm);
+}
+
+/*
+ * OBJECT CONSTRUCTORS
+ */
+
+myCalendars::myCalendars(const mySQLite &db, const std::string &sql_file_nm)
+{
+    // load holiday calendars; holidays are ordered by calendar name
+    std::string sql = read_sql(sql_file_nm, "load_all_cal_data");
+    myDataFrame * rslt = db.query(sql);
+
+    // go calendar by calendar
+    int row_idx = 0;
+    while (row_idx < rslt->tbl.values.size())
+    {
+        // calendar definition
+        std::string cal_nm = rslt->tbl.values[row_idx][0];
+        bool weekends = (stoi(rslt->tbl.values[row_idx][1]) != 0);
+        int year_first = stoi(rslt->tbl.values[row_idx][2]);
+        int year_last = stoi(rslt->tbl.values[row_idx][3]);
+
+        // holidays; calendar without holidays has a single row with empty holiday
+        std::vector<int> holidays;
+        for (; (row_idx < rslt->tbl.values.size()) && (rslt->tbl.values[row_idx][0].compare(cal_nm) == 0); row_idx++)
+        {
+            if (rslt->tbl.values[row_idx][4].compare("") != 0)
+            {
+                holidays.push_back(stoi(rslt->tbl.values[row_idx][4]));
+            }
+        }
+
+        // create calendar
+        this->cal.insert(std::pair<std::string, myCalendar>(cal_nm, myCalendar(cal_nm, holidays, weekends, year_first, year_last)));
+    }
+
+    // delete unused points
+    delete rslt;
+}
+
+/*
+ * OBJECT FUNCTIONS
+ */
+
+// get holiday calendar; joint calendar named as individual calendar names delimited by + is created on first use;
+// calendars are stored in maps, so references to them stay valid when other joint calendars are added
+const myCalendar &myCalendars::get_cal(const std::string &cal_nm) const
+{
+    // loaded calendar
+    auto it = this->cal.find(cal_nm);
+    if (it != this->cal.end())
+    {
+        return it->second;
+    }
+
+    // single calendar does not exist
+    if (cal_nm.find('+') == std::string::npos)
+    {
+        throw std::out_of_range((std::string)__func__ + ": Calendar " + cal_nm + " does not exist!");
+    }
+
+    // joint calendar already exists
+    {
+        std::shared_lock<std::shared_mutex> lock(this->joint_cal->mtx);
+        auto it_joint = this->joint_cal->cal.find(cal_nm);
+        if (it_joint != this->joint_cal->cal.end())
+        {
+            return it_joint->second;
+        }
+    }
+
+    // create joint calendar outside of the lock; if another thread was faster, its calendar is used
+    std::vector<myCalendar> cals;
+    size_t pos_begin = 0;
+    while (pos_begin <= cal_nm.size())
+    {
+        size_t pos_end = cal_nm.find('+', pos_begin);
+        if (pos_end == std::string::npos)
+        {
+            pos_end = cal_nm.size();
+        }
+        cals.push_back(this->get_cal(cal_nm.substr(pos_begin, pos_end - pos_begin)));
+        pos_begin = pos_end + 1;
+    }
+    myCalendar cal_joint = myCalendar(cal_nm, cals);
+    std::unique_lock<std::shared_mutex> lock(this->joint_cal->mtx);
+    return this->joint_cal->cal.insert(std::pair<std::string, myCalendar>(cal_nm, cal_joint)).first->second;
+}
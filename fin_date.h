@@ -1,6 +1,12 @@
 #pragma once
 
+#include <string>
+#include <map>
+#include <vector>
+#include <memory>
+#include <shared_mutex>
 #include "lib_date.h"
+#include "lib_sqlite.h"
 
 /*
 #include <string>
@@ -48,9 +54,63 @@ int main()
     std::cout << "Year fraction between dates " + date1.get_date_str() + " and " + date2.get_date_str() +\
         " assuming " + dcm + " is " + std::to_string(year_fraction) + " years" << std::endl;
 
+    // holiday calendars loaded from tables cal_def and cal_data; joint calendars are named as TARGET+NYSE
+    mySQLite db("data/finmat.db", true, 10);
+    myCalendars cals = myCalendars(db, "data/finmat.sql");
+    myDate adj_date = cals.get_cal("TARGET").adjust(myDate(20211225), bday_conv::modified_following);
+    std::cout << "25/12/2021 adjusted to TARGET business day is " + adj_date.get_date_str() << std::endl;
+
     // everything OK
     return 0;
 }
 */
 
+// day count methods
+enum class dcm_method
+{
+    undefined, // day count method not provided; it cannot be used to calculate year fractions
+    thirty_360, // 30/360 bond basis, i.e. 30_360
+    thirty_us_360, // 30/360 US, i.e. 30US_360
+    act_360, // actual / 360, i.e. ACT_360
+    act_365, // actual / 365, i.e. ACT_365
+    act_act // actual / actual ISDA, i.e. ACT_ACT
+};
+
+// day count functions
+dcm_method get_dcm_method(const std::string &dcm);
 double day_count_method(const myDate &date1, const myDate &date2, const std::string &dcm);
+double day_count_method(const myDate &date1, const myDate &date2, const dcm_method &dcm);
+void year_fractions(const std::vector<myDate> &dates_begin, const std::vector<myDate> &dates_end, const dcm_method &dcm, double * year_fracs);
+void year_fractions(const myDate &date_begin, const std::vector<myDate> &dates_end, const dcm_method &dcm, double * year_fracs);
+
+// joint calendars created on first use; shared by copies of the calendars object
+struct joint_cal_def
+{
+    std::shared_mutex mtx;
+    std::map<std::string, myCalendar> cal; // map based on joint calendar name
+};
+
+// define object holding holiday calendars; loaded calendars are not changed after construction and joint calendars
+// are created under a lock, so one object can be shared by several threads
+class myCalendars
+{
+    private:
+        // variables
+        std::shared_ptr<joint_cal_def> joint_cal = std::make_shared<joint_cal_def>();
+
+    public:
+        // object variables
+        std::map<std::string, myCalendar> cal; // map based on calendar name
+
+        // object constructors
+        myCalendars(const mySQLite &db, const std::string &sql_file_nm);
+
+        // object destructor
+        ~myCalendars(){};
+
+        // object function declarations
+        const myCalendar &get_cal(const std::string &cal_nm) const;
+};
+
+// resolve holiday calendar of a contract schedule
+const myCalendar * get_schedule_cal(const myCalendars * cals, const std::string &cal_nm, const std::string &conv_nm, bday_conv &conv, std::string &wrn_msg);
@@ -0,0 +1,156 @@
+#include <string>
+#include <vector>
+#include <math.h>
+#include <algorithm>
+#include <stdexcept>
+#include "lib_math.h"
+#include "lib_interp.h"
+#include "fin_sabr.h"
+
+/*
+ * AUXILIARY FUNCTIONS
+ */
+
+// calculate normal volatilities of a batch of strikes by Hagan et al. (2002) approximation of SABR model:
+// vol = alpha * (FK)^(beta / 2) * (1 + l^2 / 24 + l^4 / 1920) / (1 + (1 - beta)^2 l^2 / 24 + (1 - beta)^4 l^4 / 1920)
+//       * zeta / x(zeta) * (1 + eps * T), where l = log(F / K), zeta = nu / alpha * (F - K) / (FK)^(beta / 2) and
+// x(zeta) = log((sqrt(1 - 2 rho zeta + zeta^2) + zeta - rho) / (1 - rho)); the loop is branch-free and uses the
+// kernels of lib_math so that it can be vectorized; zeta / x(zeta) is replaced by its series for |zeta| < 1e-6
+void calc_sabr_normal_vol(const sabr_params &params, const double &fwd, const double &year_frac, const double * strikes, double * vols, const int &values_no)
+{
+    // terms that do not depend on strike; they are copied so that stores into vols cannot alias them
+    const double fwd_aux = fwd;
+    const double year_frac_aux = year_frac;
+    const double alpha = params.alpha;
+    const double beta = params.beta;
+    const double rho = params.rho;
+    const double nu = params.nu;
+    const double shift = params.shift;
+    const double log_fwd = fast_log(fwd_aux + shift);
+    const double beta_aux1 = (1 - beta) * (1 - beta);
+    const double beta_aux2 = beta_aux1 * beta_aux1;
+    const double eps_aux1 = -beta * (2 - beta) * alpha * alpha / 24;
+    const double eps_aux2 = rho * alpha * nu * beta / 4;
+    const double eps_aux3 = (2 - 3 * rho * rho) * nu * nu / 24;
+
+    // logarithms are not needed for beta = 0, which keeps normal SABR defined for negative rates without shift
+    const double use_logs = 0. - beta;
+
+    for (int idx = 0; idx < values_no; idx++)
+    {
+        // log moneyness and log of geometric mean of forward rate and strike
+        double log_strike = fast_log(strikes[idx] + shift);
+        double log_ratio = select_if_negative(use_logs, log_fwd - log_strike, 0.);
+        double log_mid = select_if_negative(use_logs, 0.5 * (log_fwd + log_strike), 0.);
+        double mid_beta = fast_exp(beta * log_mid); // (FK)^(beta / 2)
+        double mid_beta_aux = fast_exp((1 - beta) * log_mid); // (FK)^((1 - beta) / 2)
+
+        // moneyness correction
+        double l2 = log_ratio * log_ratio;
+        double l4 = l2 * l2;
+        double ratio = (1 + l2 / 24 + l4 / 1920) / (1 + beta_aux1 * l2 / 24 + beta_aux2 * l4 / 1920);
+
+        // zeta / x(zeta); square root is evaluated through logarithm so that the loop can be vectorized; x(zeta) is
+        // evaluated as log(1 + u) with u = (root - 1 + zeta) / (1 - rho) and root - 1 = zeta (zeta - 2 rho) / (root + 1),
+        // which avoids cancellation close to the money, and log(1 + u) = log(w) * u / (w - 1) with w = 1 + u makes up
+        // for rounding of w
+        double zeta = nu / alpha * (fwd_aux - strikes[idx]) / mid_beta;
+        double root = fast_exp(0.5 * fast_log(1 - 2 * rho * zeta + zeta * zeta));
+        double u = zeta * ((zeta - 2 * rho) / (root + 1) + 1) / (1 - rho);
+        double w = 1 + u;
+        double x = select_if_negative(0. - fabs(w - 1), fast_log(w) * (u / (w - 1)), u);
+        double zeta_x_series = 1 - 0.5 * rho * zeta + (2 - 3 * rho * rho) * zeta * zeta / 12;
+        double zeta_x = select_if_negative(fabs(zeta) - 1e-6, zeta_x_series, zeta / x);
+
+        // time correction
+        double eps = eps_aux1 / (mid_beta_aux * mid_beta_aux) + eps_aux2 / mid_beta_aux + eps_aux3;
+
+        vols[idx] = alpha * mid_beta * ratio * zeta_x * (1 + eps * year_frac_aux);
+    }
+}
+
+// calculate normal volatility of a single strike
+double calc_sabr_normal_vol(const sabr_params &params, const double &fwd, const double &year_frac, const double &strike)
+{
+    double vol;
+    calc_sabr_normal_vol(params, fwd, year_frac, &strike, &vol, 1);
+    return vol;
+}
+
+/*
+ * OBJECT CONSTRUCTORS
+ */
+
+// SABR parameters of a single scenario
+mySabrInterp::mySabrInterp(const std::vector<double> &tenors, const std::vector<sabr_params> &params)
+{
+    // check that there are parameters for each expiry
+    if (tenors.size() != params.size())
+    {
+        throw std::invalid_argument((std::string)__func__ + ": Vectors of tenors and SABR parameters must be of the same size!");
+    }
+    if (tenors.size() == 0)
+    {
+        throw std::invalid_argument((std::string)__func__ + ": At least one expiry is required!");
+    }
+
+    // order expiries in ascending order
+    std::vector<int> order(tenors.size());
+    for (int idx = 0; idx < order.size(); idx++)
+    {
+        order[idx] = idx;
+    }
+    std::sort(order.begin(), order.end(), [&tenors](const int &idx1, const int &idx2) {return tenors[idx1] < tenors[idx2];});
+    for (int idx = 0; idx < order.size(); idx++)
+    {
+        if ((idx > 0) && (tenors[order[idx]] == this->tenors.back()))
+        {
+            throw std::invalid_argument((std::string)__func__ + ": Expiry " + std::to_string(tenors[order[idx]]) + " is defined more than once!");
+        }
+        this->tenors.push_back(tenors[order[idx]]);
+        this->params.push_back(params[order[idx]]);
+    }
+}
+
+/*
+ * OBJECT FUNCTIONS
+ */
+
+// get SABR parameters of a given expiry
+sabr_params mySabrInterp::get_params(const double &tenor) const
+{
+    // get surrounding expiries
+    int idx_lower;
+    int idx_upper;
+    int hint = -1;
+    interp_locate<double, interp_extrap_flat, interp_search_binary>(this->tenors.data(), this->tenors.size(), tenor, idx_lower, idx_upper, hint);
+    if (idx_lower == idx_upper)
+    {
+        return this->params[idx_lower];
+    }
+
+    // interpolate parameters linearly
+    const sabr_params &lower = this->params[idx_lower];
+    const sabr_params &upper = this->params[idx_upper];
+    double weight = (tenor - this->tenors[idx_lower]) / (this->tenors[idx_upper] - this->tenors[idx_lower]);
+    sabr_params params;
+    params.alpha = lower.alpha + (upper.alpha - lower.alpha) * weight;
+    params.beta = lower.beta + (upper.beta - lower.beta) * weight;
+    params.rho = lower.rho + (upper.rho - lower.rho) * weight;
+    params.nu = lower.nu + (upper.nu - lower.nu) * weight;
+    params.shift = lower.shift + (upper.shift - lower.shift) * weight;
+    return params;
+}
+
+// get normal volatility of a single strike; tenor is expiry in days
+double mySabrInterp::eval(const double &tenor, const double &fwd, const double &strike) const
+{
+    return calc_sabr_normal_vol(this->get_params(tenor), fwd, tenor / 365., strike);
+}
+
+// get normal volatilities of a batch of strikes of the same expiry into caller-provided buffer; parameters are
+// interpolated only once
+void mySabrInterp::eval(const double &tenor, const double &fwd, const double * strikes, double * vols, const int &values_no) const
+{
+    calc_sabr_normal_vol(this->get_params(tenor), fwd, tenor / 365., strikes, vols, values_no);
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+/*
+#include <string>
+#include <iostream>
+#include <vector>
+#include "fin_sabr.h"
+
+int main()
+{
+    // SABR parameters of individual expiries; expiries are expressed in days from calculation date
+    std::vector<double> tenors = {365, 1825, 3650};
+    std::vector<sabr_params> params = {{0.0060, 0.0, -0.10, 0.40, 0.0},
+                                       {0.0075, 0.0, -0.20, 0.30, 0.0},
+                                       {0.0080, 0.0, -0.25, 0.25, 0.0}};
+
+    // create SABR smile object; parameters are interpolated linearly between expiries
+    mySabrInterp sabr(tenors, params);
+
+    // evaluate normal volatilities of a whole strike ladder for a given expiry and forward rate in one batch
+    std::vector<double> strikes = {-0.01, -0.005, 0.0, 0.005, 0.01, 0.02, 0.03};
+    std::vector<double> vols(strikes.size());
+    sabr.eval(1000, 0.005, strikes.data(), vols.data(), strikes.size());
+    for (int idx = 0; idx < strikes.size(); idx++)
+    {
+        std::cout << "strike: " << strikes[idx] << " -> volatility: " << vols[idx] << std::endl;
+    }
+
+    // evaluate a single strike
+    std::cout << "ATM volatility: " << sabr.eval(1000, 0.005, 0.005) << std::endl;
+
+    // everything OK
+    return 0;
+}
+*/
+
+#include <vector>
+
+// SABR parameters of a single expiry; forward rates and strikes are shifted by shift, which allows beta > 0 for
+// negative rates; beta = 0 (normal SABR) needs no shift
+struct sabr_params
+{
+    double alpha; // volatility level
+    double beta; // CEV exponent within [0, 1]
+    double rho; // correlation of forward rate and volatility
+    double nu; // volatility of volatility
+    double shift; // shift of forward rates and strikes
+};
+
+// calculate normal volatility by Hagan et al. (2002) approximation of SABR model
+double calc_sabr_normal_vol(const sabr_params &params, const double &fwd, const double &year_frac, const double &strike);
+void calc_sabr_normal_vol(const sabr_params &params, const double &fwd, const double &year_frac, const double * strikes, double * vols, const int &values_no);
+
+// define object that holds SABR parameters of a single scenario; parameters are interpolated linearly between
+// expiries and kept flat beyond the first and the last expiry; evaluation does not change the object, so one
+// object can be shared by several threads
+class mySabrInterp
+{
+    private:
+        // variables
+        std::vector<double> tenors; // expiries in days in ascending order
+        std::vector<sabr_params> params; // SABR parameters of expiries
+
+    public:
+        // object constructors
+        mySabrInterp(const std::vector<double> &tenors, const std::vector<sabr_params> &params);
+
+        // object destructor
+        ~mySabrInterp(){};
+
+        // object function declarations
+        sabr_params get_params(const double &tenor) const;
+        double eval(const double &tenor, const double &fwd, const double &strike) const;
+        void eval(const double &tenor, const double &fwd, const double * strikes, double * vols, const int &values_no) const;
+};
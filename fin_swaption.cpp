@@ -52,7 +52,7 @@ static std::vector<myDate> extract_dates_from_events(const std::vector<swpt_even
  * OBJECT CONSTRUCTORS
  */
 
-mySwaptions::mySwaptions(const mySQLite &db, const std::string &sql, const myDate &calc_date)
+mySwaptions::mySwaptions(const mySQLite &db, const std::string &sql, const myDate &calc_date, const myCalendars * cals)
 {
     // dataframe to hold result of SQL query
     myDataFrame * rslt = new myDataFrame();
@@ -62,8 +62,9 @@ mySwaptions::mySwaptions(const mySQLite &db, const std::string &sql, const myDat
 
     // auxiliary variables
     std::string aux;
-    std::vector<myDate> int_event_dates;
-    std::vector<myDate> amort_event_dates;
+    date_serie_ptr int_event_dates;
+    date_serie_ptr amort_event_dates;
+    date_serie_ptr adj_amort_event_dates;
     std::vector<myDate> end_int_dates;
 
     // reserve memory to avoid memory resize
@@ -122,6 +123,7 @@ mySwaptions::mySwaptions(const mySQLite &db, const std::string &sql, const myDat
 
             // day count method used to calculate interent payment
             swpt.dcm = rslt->tbl.values[swpt_idx][14];
+            swpt.dcm_type = get_dcm_method(swpt.dcm);
             
             // swaption rate
             aux = rslt->tbl.values[swpt_idx][15];
@@ -194,6 +196,13 @@ mySwaptions::mySwaptions(const mySQLite &db, const std::string &sql, const myDat
             // repricing curve
             swpt.crv_fwd = rslt->tbl.values[swpt_idx][22];
 
+            // holiday calendar and business day convention; the columns are missing in tables created before they
+            // were introduced
+            std::string cal_nm = (rslt->tbl.values[swpt_idx].size() > 23) ? rslt->tbl.values[swpt_idx][23] : "";
+            std::string conv_nm = (rslt->tbl.values[swpt_idx].size() > 24) ? rslt->tbl.values[swpt_idx][24] : "";
+            const myCalendar * cal = get_schedule_cal(cals, cal_nm, conv_nm, swpt.conv, swpt.wrn_msg);
+            swpt.cal_nm = (cal != nullptr) ? cal_nm : "";
+
         // perform other sanity checks
        
             // value date
@@ -235,6 +244,14 @@ mySwaptions::mySwaptions(const mySQLite &db, const std::string &sql, const myDat
                 }
             }
 
+        // parse frequencies into tenors; events are generated without any further string manipulation
+
+            swpt.fix_tenor = parse_tenor(swpt.fix_freq);
+            if (swpt.amort_freq.compare("") != 0)
+            {
+                swpt.amort_tenor = parse_tenor(swpt.amort_freq);
+            }
+
         // generate vector of events
 
             // variables containing dates
@@ -247,19 +264,25 @@ mySwaptions::mySwaptions(const mySQLite &db, const std::string &sql, const myDat
 
             // position index
             int pos_idx;
+            std::vector<int> pos_idxs;
 
-            // date format, which is used to store date string in object myDate
-            std::string date_format = "yyyymmdd";
-
-            // create vector interest events; we assume that all other events occur on interest payment dates
-            int_event_dates = create_date_serie(swpt.value_date.get_date_str(), swpt.maturity_date.get_date_str(), swpt.fix_freq, date_format);     
+            // create vector interest events; we assume that all other events occur on interest payment dates, which
+            // are adjusted to business days if the swaption has a holiday calendar
+            if (cal != nullptr)
+            {
+                int_event_dates = get_date_serie(swpt.value_date, swpt.maturity_date, swpt.fix_tenor, *cal, swpt.conv);
+            }
+            else
+            {
+                int_event_dates = get_date_serie(swpt.value_date, swpt.maturity_date, swpt.fix_tenor);
+            }
 
             // create a vector of events based on interest payment dates
-            for (int idx = 0; idx < int_event_dates.size() - 1; idx++)
+            for (int idx = 0; idx < int_event_dates->size() - 1; idx++)
             {
-                evnt.date_begin = int_event_dates[idx];
-                evnt.date_end = int_event_dates[idx + 1];
-                evnt.int_year_frac = day_count_method(evnt.date_begin, evnt.date_end, swpt.dcm);
+                evnt.date_begin = (*int_event_dates)[idx];
+                evnt.date_end = (*int_event_dates)[idx + 1];
+                evnt.int_year_frac = day_count_method(evnt.date_begin, evnt.date_end, swpt.dcm_type);
                 events.emplace_back(evnt);
             }
 
@@ -270,23 +293,28 @@ mySwaptions::mySwaptions(const mySQLite &db, const std::string &sql, const myDat
                 date1 = swpt.first_amort_date;
                 while (date1.get_days_no() < calc_date.get_days_no())
                 {
-                    date1.add(swpt.amort_freq);
+                    date1.add(swpt.amort_tenor);
                 }
 
                 // date1 is the first amortization date => we generate amortizaton dates till maturity
-                amort_event_dates = create_date_serie(date1.get_date_str(), swpt.maturity_date.get_date_str(), swpt.amort_freq, date_format);
+                amort_event_dates = get_date_serie(date1, swpt.maturity_date, swpt.amort_tenor);
+                adj_amort_event_dates = (cal != nullptr) ? get_date_serie(date1, swpt.maturity_date, swpt.amort_tenor, *cal, swpt.conv) : amort_event_dates;
 
                 // extract begin and end dates of the coupon periods
                 end_int_dates = extract_dates_from_events(events, "date_end");
 
 
+                // match adjusted amortization dates with the nearest interest period end dates in a single merge pass
+                pos_idxs.resize(amort_event_dates->size());
+                match_dates(*adj_amort_event_dates, end_int_dates, date_match::nearest, pos_idxs.data());
+
                 // go amortization date by amortization date and assign it the nearest coupon date; we assume that amortizations happen on coupon dates
-                for (int idx = 0; idx < amort_event_dates.size(); idx++)
+                for (int idx = 0; idx < amort_event_dates->size(); idx++)
                 {
                     // we assign amortization flag based on begining interest payment date
-                    if (amort_event_dates[idx].get_date_int() < swpt.maturity_date.get_date_int())
+                    if ((*amort_event_dates)[idx].get_date_int() < swpt.maturity_date.get_date_int())
                     {
-                        pos_idx = get_nearest_idx(amort_event_dates[idx], end_int_dates, "abs");
+                        pos_idx = pos_idxs[idx];
                         events[pos_idx].amort_flg = true;
                     }
                 }
@@ -410,6 +438,10 @@ void mySwaptions::calc_npv(const int &scn_no, const myCurves &crvs, const myFx &
     // go intrument by intrument
     for (int swpt_idx = 0; swpt_idx < this->info.size(); swpt_idx++)
     {
+        // resolve curve handles so that curves are not looked up by name event by event
+        this->info[swpt_idx].crv_disc_idx = crvs.get_crv_idx(this->info[swpt_idx].crv_disc);
+        this->info[swpt_idx].crv_fwd_idx = (this->info[swpt_idx].crv_fwd.size() > 0) ? crvs.get_crv_idx(this->info[swpt_idx].crv_fwd) : -1;
+
         // clear selected fields
         this->info[swpt_idx].aux1 = 0.0;
         this->info[swpt_idx].aux2 = 0.0;
@@ -424,12 +456,12 @@ void mySwaptions::calc_npv(const int &scn_no, const myCurves &crvs, const myFx &
             scn_tenors.clear();
             scn_tenors.push_back(std::tuple<int, int>(scn_no, this->info[swpt_idx].events[idx].date_begin.get_date_int()));
             scn_tenors.push_back(std::tuple<int, int>(scn_no, this->info[swpt_idx].events[idx].date_end.get_date_int()));
-            this->info[swpt_idx].events[idx].fwd = crvs.get_fwd_rate(this->info[swpt_idx].crv_fwd, scn_tenors, this->info[swpt_idx].dcm)[0];
+            this->info[swpt_idx].events[idx].fwd = crvs.get_fwd_rate(this->info[swpt_idx].crv_fwd_idx, scn_tenors, this->info[swpt_idx].dcm_type)[0];
 
             // calculate discount factor
             scn_tenors.clear();
             scn_tenors.push_back(std::tuple<int, int>(scn_no, this->info[swpt_idx].events[idx].date_end.get_date_int()));
-            this->info[swpt_idx].events[idx].df = crvs.get_df(this->info[swpt_idx].crv_disc, scn_tenors)[0];
+            this->info[swpt_idx].events[idx].df = crvs.get_df(this->info[swpt_idx].crv_disc_idx, scn_tenors)[0];
 
             // calculate NPV components
             aux1 = this->info[swpt_idx].events[idx].nominal_begin * this->info[swpt_idx].events[idx].int_year_frac * this->info[swpt_idx].events[idx].df;
@@ -442,12 +474,15 @@ void mySwaptions::calc_npv(const int &scn_no, const myCurves &crvs, const myFx &
         // determine rate of the underlying swap
         this->info[swpt_idx].swap_rate = (this->info[swpt_idx].flt_leg_npv - this->info[swpt_idx].aux2) / this->info[swpt_idx].aux1;
 
-        // get volatility
-        std::vector<double> tenors = {static_cast<double>(this->info[swpt_idx].value_date.get_days_no() - this->info[swpt_idx].calc_date.get_days_no())};
-        this->info[swpt_idx].swaption_vol = vol_surfs.get_vols(this->info[swpt_idx].swaption_vol_surf, scn_no, tenors, {this->info[swpt_idx].swaption_rate})[0];
+        // get volatility; volatility cubes are interpolated also in length of the underlying swap and SABR surfaces
+        // are evaluated at the rate of the underlying swap
+        double tenor = this->info[swpt_idx].value_date.get_days_no() - this->info[swpt_idx].calc_date.get_days_no();
+        double swap_tenor = this->info[swpt_idx].maturity_date.get_days_no() - this->info[swpt_idx].value_date.get_days_no();
+        vol_surf_handle swaption_vol_surf = vol_surfs.get_vol_handle(this->info[swpt_idx].swaption_vol_surf, scn_no);
+        this->info[swpt_idx].swaption_vol = swaption_vol_surf.get_vol(tenor, swap_tenor, this->info[swpt_idx].swap_rate, this->info[swpt_idx].swaption_rate);
 
         // calculate swaption maturity
-        double swpt_mat = day_count_method(this->info[swpt_idx].calc_date, this->info[swpt_idx].value_date, this->info[swpt_idx].dcm);
+        double swpt_mat = day_count_method(this->info[swpt_idx].calc_date, this->info[swpt_idx].value_date, this->info[swpt_idx].dcm_type);
 
         // calculation swaption price
         this->info[swpt_idx].d = (this->info[swpt_idx].swap_rate - this->info[swpt_idx].swaption_rate) / (this->info[swpt_idx].swaption_vol * std::sqrt(swpt_mat));
@@ -459,8 +494,8 @@ void mySwaptions::calc_npv(const int &scn_no, const myCurves &crvs, const myFx &
         {
             this->info[swpt_idx].aux3 = -1.0;
         }
-        this->info[swpt_idx].aux4 = this->info[swpt_idx].aux3 * (this->info[swpt_idx].swap_rate - this->info[swpt_idx].swaption_rate) * norm_cdf({this->info[swpt_idx].aux3 * this->info[swpt_idx].d})[0];
-        this->info[swpt_idx].npv = (this->info[swpt_idx].aux4 + this->info[swpt_idx].swaption_vol * std::sqrt(swpt_mat) * norm_pdf({this->info[swpt_idx].d})[0]) * this->info[swpt_idx].aux1;
+        this->info[swpt_idx].aux4 = this->info[swpt_idx].aux3 * (this->info[swpt_idx].swap_rate - this->info[swpt_idx].swaption_rate) * norm_cdf(this->info[swpt_idx].aux3 * this->info[swpt_idx].d);
+        this->info[swpt_idx].npv = (this->info[swpt_idx].aux4 + this->info[swpt_idx].swaption_vol * std::sqrt(swpt_mat) * norm_pdf(this->info[swpt_idx].d)) * this->info[swpt_idx].aux1;
 
         // calculate NPV in reference currency
         std::tuple<int, std::string> scn_ccy = std::tuple<int, std::string>(scn_no, ref_ccy_nm);
@@ -26,6 +26,8 @@ int main()
     std::string spreadcrv_bef = "data/curves/spreadcrv_bef.csv";
     std::string vol_surf_def = "data/vol_surf_def.csv";
     std::string vol_surf_data = "data/vol_surf_data.csv";
+    std::string vol_cube_data = "data/vol_cube_data.csv";
+    std::string vol_sabr_data = "data/vol_sabr_data.csv";
     std::string cap_floor_data = "data/swpt_data.csv";
     std::string sql;
     myDataFrame * rslt = new myDataFrame();
@@ -68,6 +70,12 @@ int main()
     sql = read_sql(sql_file_nm, "vol_surf_data");
     db.exec(sql);
 
+    sql = read_sql(sql_file_nm, "vol_cube_data");
+    db.exec(sql);
+
+    sql = read_sql(sql_file_nm, "vol_sabr_data");
+    db.exec(sql);
+
     sql = read_sql(sql_file_nm, "swaption_data");
     db.exec(sql);
 
@@ -84,6 +92,8 @@ int main()
     db.exec("DELETE FROM crv_data;");
     db.exec("DELETE FROM vol_surf_def;");
     db.exec("DELETE FROM vol_surf_data;");
+    db.exec("DELETE FROM vol_cube_data;");
+    db.exec("DELETE FROM vol_sabr_data;");
     db.exec("DELETE FROM swaption_data;");
     db.exec("DELETE FROM swaption_npv;");
 
@@ -128,6 +138,14 @@ int main()
     db.upload_tbl(*rslt, "vol_surf_data", delete_old_data);
     rslt->clear();
 
+    rslt->read(vol_cube_data, sep, quotes);
+    db.upload_tbl(*rslt, "vol_cube_data", delete_old_data);
+    rslt->clear();
+
+    rslt->read(vol_sabr_data, sep, quotes);
+    db.upload_tbl(*rslt, "vol_sabr_data", delete_old_data);
+    rslt->clear();
+
     rslt->read(cap_floor_data, sep, quotes);
     db.upload_tbl(*rslt, "swaption_data", delete_old_data);
     rslt->clear();
@@ -217,6 +235,7 @@ int main()
 #include <vector>
 #include <thread>
 #include "lib_date.h"
+#include "fin_date.h"
 #include "fin_curve.h"
 #include "fin_fx.h"
 #include "fin_vol_surf.h"
@@ -254,16 +273,23 @@ struct swpt_info
 	myDate value_date;
 	myDate maturity_date;
     std::string dcm;
+    dcm_method dcm_type = dcm_method::undefined; // day count method resolved from dcm
     double swaption_rate = 0.0;
     double swap_rate = 0.0;
     std::string swaption_vol_surf;
     double swaption_vol = 0.0;
     std::string fix_freq;
+    tenor_def fix_tenor; // tenor parsed from fix_freq once per contract
 	myDate first_amort_date;
 	std::string amort_freq;
+    tenor_def amort_tenor; // tenor parsed from amort_freq once per contract
 	double amort = 0.0;
 	std::string crv_disc;
 	std::string crv_fwd;
+    std::string cal_nm; // holiday calendar of swap, fixing and amortization dates
+    bday_conv conv = bday_conv::unadjusted; // business day convention applied to the dates
+    int crv_disc_idx = -1; // curve handles resolved when NPV is calculated
+    int crv_fwd_idx = -1;
     double d = 0.0;
     double aux1 = 0.0;
     double aux2 = 0.0;
@@ -289,7 +315,7 @@ class mySwaptions
     public:
         // object constructors
         mySwaptions(std::vector<swpt_info> info){this->info = info;};
-        mySwaptions(const mySQLite &db, const std::string &sql, const myDate &calc_date);
+        mySwaptions(const mySQLite &db, const std::string &sql, const myDate &calc_date, const myCalendars * cals = nullptr);
 
         // copy constructor
         mySwaptions(const mySwaptions &swpts){this->info = swpts.info;};
@@ -3,11 +3,58 @@
 #include <math.h>
 #include <tuple> 
 #include <vector>
+#include <algorithm>
+#include <stdexcept>
 #include "lib_sqlite.h"
 #include "lib_lininterp.h"
 #include "fin_date.h"
 #include "fin_vol_surf.h"
 
+/*
+ * AUXILIARY FUNCTIONS
+ */
+
+// detect unique co-ordinates of a grid axis in ascending order
+static std::vector<double> get_grid_axis(const std::vector<double> &x)
+{
+    std::vector<double> axis = x;
+    std::sort(axis.begin(), axis.end());
+    axis.erase(std::unique(axis.begin(), axis.end()), axis.end());
+    return axis;
+}
+
+// compile volatility cube into a dense grid of expiries, swap tenors and strikes; the data must hold one volatility
+// for each combination of expiry, swap tenor and strike
+static myGridInterp<double, 3> compile_vol_cube(const vol_cube_def &vol_cube, const std::string &vol_surf_nm)
+{
+    // detect axes of the grid
+    std::vector<double> tenors = get_grid_axis(vol_cube.tenors);
+    std::vector<double> swap_tenors = get_grid_axis(vol_cube.swap_tenors);
+    std::vector<double> strikes = get_grid_axis(vol_cube.strikes);
+    if (tenors.size() * swap_tenors.size() * strikes.size() != vol_cube.volatilities.size())
+    {
+        throw std::invalid_argument((std::string)__func__ + ": Volatility cube " + vol_surf_nm + " must hold one volatility for each combination of tenor, swap tenor and strike!");
+    }
+
+    // place volatilities into the grid; strikes are the fastest dimension
+    std::vector<double> volatilities(vol_cube.volatilities.size(), 0.0);
+    std::vector<bool> is_set(vol_cube.volatilities.size(), false);
+    for (int idx = 0; idx < vol_cube.volatilities.size(); idx++)
+    {
+        int tenor_idx = std::lower_bound(tenors.begin(), tenors.end(), vol_cube.tenors[idx]) - tenors.begin();
+        int swap_tenor_idx = std::lower_bound(swap_tenors.begin(), swap_tenors.end(), vol_cube.swap_tenors[idx]) - swap_tenors.begin();
+        int strike_idx = std::lower_bound(strikes.begin(), strikes.end(), vol_cube.strikes[idx]) - strikes.begin();
+        int grid_idx = (tenor_idx * swap_tenors.size() + swap_tenor_idx) * strikes.size() + strike_idx;
+        if (is_set[grid_idx])
+        {
+            throw std::invalid_argument((std::string)__func__ + ": Volatility cube " + vol_surf_nm + " defines a grid point more than once!");
+        }
+        volatilities[grid_idx] = vol_cube.volatilities[idx];
+        is_set[grid_idx] = true;
+    }
+    return myGridInterp<double, 3>({tenors, swap_tenors, strikes}, volatilities);
+}
+
 /*
  * OBJECT CONSTRUCTORS
  */
@@ -31,41 +78,38 @@ myVolSurface::myVolSurface(const mySQLite &db, const std::string &sql_file_nm, c
     this->ccy_nm = rslt->tbl.values[0][1];
     this->vol_surf_type = rslt->tbl.values[0][2];
     this->underlying = rslt->tbl.values[0][3];
+    delete rslt;
+
+    // volatility cubes and SABR parameters are stored in separate tables
+    if (this->is_vol_cube())
+    {
+        this->load_vol_cube(db, sql_file_nm);
+        return;
+    }
+    if (this->is_vol_sabr())
+    {
+        this->load_vol_sabr(db, sql_file_nm);
+        return;
+    }
 
     // load volatility surface data
     sql = read_sql(sql_file_nm, "load_vol_surf_data");
     sql = replace_in_sql(sql, "##vol_surf_nm##", "'" + vol_surf_nm + "'");
     rslt = db.query(sql);
 
-    // go scenario by scenario
-    int scn_no = -1;
-    bool is_new_scn = false;
-    std::vector<double> tenors;
-    std::vector<double> strikes;
-    std::vector<double> volatilities;
-
+    // split data by scenario; rows of a scenario do not have to be contiguous
     for (int idx = 0; idx < rslt->tbl.values.size(); idx++)
     {
-        // check that you have encountered a new scenario or you are at the end of file
-        if (((stoi(rslt->tbl.values[idx][0]) != scn_no) && (scn_no != -1)) || (idx == rslt->tbl.values.size() - 1))
-        {
-            // create a tuple of scenario and volatility surface
-            vol_surf_def vol_surf_aux = {tenors, strikes, volatilities};
-            std::tuple<int, vol_surf_def> vol_surf = {scn_no, vol_surf_aux};
-            this->vol_surf.insert(std::pair<int, vol_surf_def>(scn_no, vol_surf_aux));
-
-            // clear variables
-            tenors.clear();
-            strikes.clear();
-            volatilities.clear();
-        }
-        // load data
-        {
-            scn_no = stoi(rslt->tbl.values[idx][0]);
-            tenors.push_back(stod(rslt->tbl.values[idx][1]));
-            strikes.push_back(stod(rslt->tbl.values[idx][2]));
-            volatilities.push_back(stod(rslt->tbl.values[idx][3]));
-        }
+        vol_surf_def &vol_surf_aux = this->vol_surf[stoi(rslt->tbl.values[idx][0])];
+        vol_surf_aux.tenors.push_back(stod(rslt->tbl.values[idx][1]));
+        vol_surf_aux.strikes.push_back(stod(rslt->tbl.values[idx][2]));
+        vol_surf_aux.volatilities.push_back(stod(rslt->tbl.values[idx][3]));
+    }
+
+    // compile interpolation object of each scenario once so that it is shared by all subsequent lookups
+    for (std::map<int, vol_surf_def>::const_iterator it = this->vol_surf.begin(); it != this->vol_surf.end(); it++)
+    {
+        this->vol_surf_interp.insert(std::pair<int, myLinInterp2D>(it->first, myLinInterp2D(it->second.tenors, it->second.strikes, it->second.volatilities)));
     }
 
     // delete unused pointers
@@ -102,22 +146,199 @@ myVolSurfaces::myVolSurfaces(const mySQLite &db, const std::string &sql_file_nm)
  * OBJECT FUNCTIONS
  */
 
+// load volatility cube data and compile volatility cube of each scenario
+void myVolSurface::load_vol_cube(const mySQLite &db, const std::string &sql_file_nm)
+{
+    // load volatility cube data
+    std::string sql = read_sql(sql_file_nm, "load_vol_cube_data");
+    sql = replace_in_sql(sql, "##vol_surf_nm##", "'" + this->vol_surf_nm + "'");
+    myDataFrame * rslt = db.query(sql);
+
+    // split data by scenario
+    std::map<int, vol_cube_def> vol_cubes;
+    for (int idx = 0; idx < rslt->tbl.values.size(); idx++)
+    {
+        vol_cube_def &vol_cube = vol_cubes[stoi(rslt->tbl.values[idx][0])];
+        vol_cube.tenors.push_back(stod(rslt->tbl.values[idx][1]));
+        vol_cube.swap_tenors.push_back(stod(rslt->tbl.values[idx][2]));
+        vol_cube.strikes.push_back(stod(rslt->tbl.values[idx][3]));
+        vol_cube.volatilities.push_back(stod(rslt->tbl.values[idx][4]));
+    }
+    delete rslt;
+
+    // compile volatility cube of each scenario
+    for (std::map<int, vol_cube_def>::const_iterator it = vol_cubes.begin(); it != vol_cubes.end(); it++)
+    {
+        this->vol_cube_interp.insert(std::pair<int, myGridInterp<double, 3>>(it->first, compile_vol_cube(it->second, this->vol_surf_nm)));
+    }
+}
+
+// load SABR parameters of each scenario
+void myVolSurface::load_vol_sabr(const mySQLite &db, const std::string &sql_file_nm)
+{
+    // load SABR parameters
+    std::string sql = read_sql(sql_file_nm, "load_vol_sabr_data");
+    sql = replace_in_sql(sql, "##vol_surf_nm##", "'" + this->vol_surf_nm + "'");
+    myDataFrame * rslt = db.query(sql);
+
+    // split data by scenario
+    std::map<int, std::tuple<std::vector<double>, std::vector<sabr_params>>> vol_sabrs;
+    for (int idx = 0; idx < rslt->tbl.values.size(); idx++)
+    {
+        std::tuple<std::vector<double>, std::vector<sabr_params>> &vol_sabr = vol_sabrs[stoi(rslt->tbl.values[idx][0])];
+        std::get<0>(vol_sabr).push_back(stod(rslt->tbl.values[idx][1]));
+        std::get<1>(vol_sabr).push_back({stod(rslt->tbl.values[idx][2]), stod(rslt->tbl.values[idx][3]), stod(rslt->tbl.values[idx][4]), stod(rslt->tbl.values[idx][5]), stod(rslt->tbl.values[idx][6])});
+    }
+    delete rslt;
+
+    // store SABR parameters of each scenario
+    for (std::map<int, std::tuple<std::vector<double>, std::vector<sabr_params>>>::const_iterator it = vol_sabrs.begin(); it != vol_sabrs.end(); it++)
+    {
+        this->vol_sabr_interp.insert(std::pair<int, mySabrInterp>(it->first, mySabrInterp(std::get<0>(it->second), std::get<1>(it->second))));
+    }
+}
+
+// get handle to volatility surface of a scenario compiled at load
+vol_surf_handle myVolSurface::get_vol_handle(const int &scn_no) const
+{
+    vol_surf_handle handle;
+    if (this->is_vol_sabr())
+    {
+        handle.vol_sabr = &this->get_vol_sabr_interp(scn_no);
+    }
+    else if (this->is_vol_cube())
+    {
+        handle.vol_cube = &this->get_vol_cube_interp(scn_no);
+    }
+    else
+    {
+        handle.vol_surf = &this->get_vol_surf_interp(scn_no);
+    }
+    return handle;
+}
+
+// get compiled interpolation object of a scenario; the object is immutable, so the reference can be kept and shared
+// by several threads as long as the volatility surface exists
+const myLinInterp2D &myVolSurface::get_vol_surf_interp(const int &scn_no) const
+{
+    if (this->is_vol_cube() || this->is_vol_sabr())
+    {
+        throw std::invalid_argument((std::string)__func__ + ": Volatility surface " + this->vol_surf_nm + " is of " + this->vol_surf_type + " type!");
+    }
+    std::map<int, myLinInterp2D>::const_iterator it = this->vol_surf_interp.find(scn_no);
+    if (it == this->vol_surf_interp.end())
+    {
+        throw std::out_of_range((std::string)__func__ + ": Scenario " + std::to_string(scn_no) + " of volatility surface " + this->vol_surf_nm + " does not exist!");
+    }
+    return it->second;
+}
+
+// get compiled volatility cube of a scenario; the object is immutable, so the reference can be kept and shared by
+// several threads as long as the volatility surface exists
+const myGridInterp<double, 3> &myVolSurface::get_vol_cube_interp(const int &scn_no) const
+{
+    if (!this->is_vol_cube())
+    {
+        throw std::invalid_argument((std::string)__func__ + ": Volatility surface " + this->vol_surf_nm + " is not a volatility cube!");
+    }
+    std::map<int, myGridInterp<double, 3>>::const_iterator it = this->vol_cube_interp.find(scn_no);
+    if (it == this->vol_cube_interp.end())
+    {
+        throw std::out_of_range((std::string)__func__ + ": Scenario " + std::to_string(scn_no) + " of volatility cube " + this->vol_surf_nm + " does not exist!");
+    }
+    return it->second;
+}
+
+// get SABR parameters of a scenario; the object is immutable, so the reference can be kept and shared by several
+// threads as long as the volatility surface exists
+const mySabrInterp &myVolSurface::get_vol_sabr_interp(const int &scn_no) const
+{
+    if (!this->is_vol_sabr())
+    {
+        throw std::invalid_argument((std::string)__func__ + ": Volatility surface " + this->vol_surf_nm + " is not of sabr type!");
+    }
+    std::map<int, mySabrInterp>::const_iterator it = this->vol_sabr_interp.find(scn_no);
+    if (it == this->vol_sabr_interp.end())
+    {
+        throw std::out_of_range((std::string)__func__ + ": Scenario " + std::to_string(scn_no) + " of volatility surface " + this->vol_surf_nm + " does not exist!");
+    }
+    return it->second;
+}
+
 // get surface volatilities based on scenario number and vector of maturities and strikes
 std::vector<double> myVolSurface::get_vols(const int &scn_no, const std::vector<double> &tenors, const std::vector<double> &strikes) const
 {
-    // initiate 2D interpolation object
-    vol_surf_def vol_surf_aux = this->vol_surf.at(scn_no);
-    myLinInterp2D interp2D(vol_surf_aux.tenors, vol_surf_aux.strikes, vol_surf_aux.volatilities);
+    return this->get_vol_surf_interp(scn_no).eval(tenors, strikes);
+}
+
+// get cube volatilities based on scenario number and vectors of maturities, swap tenors and strikes
+std::vector<double> myVolSurface::get_vols(const int &scn_no, const std::vector<double> &tenors, const std::vector<double> &swap_tenors, const std::vector<double> &strikes) const
+{
+    if ((tenors.size() != swap_tenors.size()) || (tenors.size() != strikes.size()))
+    {
+        throw std::invalid_argument((std::string)__func__ + ": Vectors of tenors, swap tenors and strikes must be of the same size!");
+    }
+    std::vector<double> vols(tenors.size());
+    this->get_vols(scn_no, tenors.data(), swap_tenors.data(), strikes.data(), vols.data(), tenors.size());
+    return vols;
+}
+
+// get cube volatilities into caller-provided buffer
+void myVolSurface::get_vols(const int &scn_no, const double * tenors, const double * swap_tenors, const double * strikes, double * vols, const int &values_no) const
+{
+    this->get_vol_cube_interp(scn_no).eval({tenors, swap_tenors, strikes}, vols, values_no);
+}
+
+// get volatility surface based on its name
+const myVolSurface &myVolSurfaces::get_vol_surf(const std::string &vol_surf_nm) const
+{
+    std::map<std::string, myVolSurface>::const_iterator it = this->vol_surf.find(vol_surf_nm);
+    if (it == this->vol_surf.end())
+    {
+        throw std::out_of_range((std::string)__func__ + ": Volatility surface " + vol_surf_nm + " does not exist!");
+    }
+    return it->second;
+}
+
+// get handle to volatility surface based on volatility surface name and scenario number
+vol_surf_handle myVolSurfaces::get_vol_handle(const std::string &vol_surf_nm, const int &scn_no) const
+{
+    return this->get_vol_surf(vol_surf_nm).get_vol_handle(scn_no);
+}
 
-    // interpolate volatilities
-    std::vector<double> volatilities = interp2D.eval(tenors, strikes);
+// get compiled interpolation object based on volatility surface name and scenario number
+const myLinInterp2D &myVolSurfaces::get_vol_surf_interp(const std::string &vol_surf_nm, const int &scn_no) const
+{
+    return this->get_vol_surf(vol_surf_nm).get_vol_surf_interp(scn_no);
+}
 
-    // return interpolated volatilities
-    return volatilities;
+// get compiled volatility cube based on volatility surface name and scenario number
+const myGridInterp<double, 3> &myVolSurfaces::get_vol_cube_interp(const std::string &vol_surf_nm, const int &scn_no) const
+{
+    return this->get_vol_surf(vol_surf_nm).get_vol_cube_interp(scn_no);
+}
+
+// get SABR parameters based on volatility surface name and scenario number
+const mySabrInterp &myVolSurfaces::get_vol_sabr_interp(const std::string &vol_surf_nm, const int &scn_no) const
+{
+    return this->get_vol_surf(vol_surf_nm).get_vol_sabr_interp(scn_no);
 }
 
-// get year fraction based on vector of scenario numbers and tenor integer dates in yyyymmdd format
+// get surface volatilities based on volatility surface name, scenario number and vector of maturities and strikes
 std::vector<double> myVolSurfaces::get_vols(const std::string &vol_surf_nm, const int &scn_no, const std::vector<double> &tenors, const std::vector<double> &strikes) const
 {
-    return this->vol_surf.at(vol_surf_nm).get_vols(scn_no, tenors, strikes);
-}
\ No newline at end of file
+    return this->get_vol_surf_interp(vol_surf_nm, scn_no).eval(tenors, strikes);
+}
+
+// get cube volatilities based on volatility surface name, scenario number and vectors of maturities, swap tenors
+// and strikes
+std::vector<double> myVolSurfaces::get_vols(const std::string &vol_surf_nm, const int &scn_no, const std::vector<double> &tenors, const std::vector<double> &swap_tenors, const std::vector<double> &strikes) const
+{
+    return this->get_vol_surf(vol_surf_nm).get_vols(scn_no, tenors, swap_tenors, strikes);
+}
+
+// get cube volatilities into caller-provided buffer
+void myVolSurfaces::get_vols(const std::string &vol_surf_nm, const int &scn_no, const double * tenors, const double * swap_tenors, const double * strikes, double * vols, const int &values_no) const
+{
+    this->get_vol_surf(vol_surf_nm).get_vols(scn_no, tenors, swap_tenors, strikes, vols, values_no);
+}
@@ -14,6 +14,8 @@ int main()
     std::string ccy_def = "data/ccy_def.csv";
     std::string vol_surf_def = "data/vol_surf_def.csv";
     std::string vol_surf_data = "data/vol_surf_data.csv";
+    std::string vol_cube_data = "data/vol_cube_data.csv";
+    std::string vol_sabr_data = "data/vol_sabr_data.csv";
     std::string sql;
     myDataFrame * rslt = new myDataFrame();
     myDate calc_date = myDate(20211203);
@@ -40,11 +42,19 @@ int main()
     sql = read_sql(sql_file_nm, "vol_surf_data");
     db.exec(sql);
 
+    sql = read_sql(sql_file_nm, "vol_cube_data");
+    db.exec(sql);
+
+    sql = read_sql(sql_file_nm, "vol_sabr_data");
+    db.exec(sql);
+
     // delete old content in the tables
     db.exec("DELETE FROM cnty_def;");
     db.exec("DELETE FROM ccy_def;");
     db.exec("DELETE FROM vol_surf_def;");
     db.exec("DELETE FROM vol_surf_data;");
+    db.exec("DELETE FROM vol_cube_data;");
+    db.exec("DELETE FROM vol_sabr_data;");
 
     // create dataframes from .csv files and store them into database
     rslt->read(cnty_def, sep, quotes);
@@ -63,6 +73,14 @@ int main()
     db.upload_tbl(*rslt, "vol_surf_data", delete_old_data);
     rslt->clear();
 
+    rslt->read(vol_cube_data, sep, quotes);
+    db.upload_tbl(*rslt, "vol_cube_data", delete_old_data);
+    rslt->clear();
+
+    rslt->read(vol_sabr_data, sep, quotes);
+    db.upload_tbl(*rslt, "vol_sabr_data", delete_old_data);
+    rslt->clear();
+
     // vacuum SQLite database file to avoid its excessive growth
     db.vacuum();
 
@@ -84,6 +102,33 @@ int main()
         std::cout << "tenor: " + std::to_string(static_cast<int>(tenors[idx])) + "D, strike: " + std::to_string(strikes[idx]) + " -> volatility: " + std::to_string(volatilities[idx]) << std::endl;
     }
 
+    // repeated lookups should use a handle to the compiled surface; it is resolved once and it does not allocate
+    const myLinInterp2D &vol_surf = vol_surfs.get_vol_surf_interp(vol_surf_nm, scn_no);
+    std::cout << "tenor: 1000D, strike: 0.010000 -> volatility: " + std::to_string(vol_surf.eval(1000, 0.01)) << std::endl;
+
+    // swaption volatility cube is interpolated in expiry, length of underlying swap and strike
+    std::vector<double> swap_tenors = {1825, 1825, 3650, 10950};
+    std::vector<double> cube_vols(tenors.size());
+    vol_surfs.get_vols("SWPT_CUBE_EUR", scn_no, tenors.data(), swap_tenors.data(), strikes.data(), cube_vols.data(), tenors.size());
+    for (int idx = 0; idx < tenors.size(); idx++)
+    {
+        std::cout << "tenor: " + std::to_string(static_cast<int>(tenors[idx])) + "D, swap tenor: " + std::to_string(static_cast<int>(swap_tenors[idx])) + "D, strike: " + std::to_string(strikes[idx]) + " -> volatility: " + std::to_string(cube_vols[idx]) << std::endl;
+    }
+
+    // SABR surface depends also on forward rate; a whole strike ladder of one expiry is evaluated in one batch
+    const mySabrInterp &sabr = vol_surfs.get_vol_sabr_interp("CAP_SABR_EUR", scn_no);
+    std::vector<double> ladder = {-0.01, 0.0, 0.01, 0.02, 0.03};
+    std::vector<double> sabr_vols(ladder.size());
+    sabr.eval(1000, 0.005, ladder.data(), sabr_vols.data(), ladder.size());
+    for (int idx = 0; idx < ladder.size(); idx++)
+    {
+        std::cout << "tenor: 1000D, forward: 0.005000, strike: " + std::to_string(ladder[idx]) + " -> volatility: " + std::to_string(sabr_vols[idx]) << std::endl;
+    }
+
+    // pricers resolve a handle once per instrument and scenario; it works with any type of volatility surface
+    vol_surf_handle vol_handle = vol_surfs.get_vol_handle("CAP_SABR_EUR", scn_no);
+    std::cout << "handle volatility: " + std::to_string(vol_handle.get_vol(1000, 0.0, 0.005, 0.01)) << std::endl;
+
     // everything OK
     return 0;
 }
@@ -97,6 +142,8 @@ int main()
 #include "lib_sqlite.h"
 #include "lib_date.h"
 #include "lib_lininterp.h"
+#include "lib_interp.h"
+#include "fin_sabr.h"
 
 // volatility surface structure
 struct vol_surf_def
@@ -106,9 +153,49 @@ struct vol_surf_def
     std::vector<double> volatilities;
 };
 
+// volatility cube structure; tenors are expiries and swap tenors are lengths of underlying swaps, both in days
+struct vol_cube_def
+{
+    std::vector<double> tenors;
+    std::vector<double> swap_tenors;
+    std::vector<double> strikes;
+    std::vector<double> volatilities;
+};
+
+// handle to volatility surface of a single scenario compiled at load; exactly one of the pointers is set; the handle
+// does not own the compiled object, so it is valid as long as the volatility surfaces exist
+struct vol_surf_handle
+{
+    const myLinInterp2D * vol_surf = nullptr;
+    const myGridInterp<double, 3> * vol_cube = nullptr;
+    const mySabrInterp * vol_sabr = nullptr;
+
+    // SABR surfaces are quoted by option expiry, i.e. fixing date, while caplet surfaces are quoted by caplet maturity
+    bool is_sabr() const {return this->vol_sabr != nullptr;};
+
+    // get volatility; swap tenor is used only by volatility cubes and forward rate only by SABR surfaces
+    double get_vol(const double &tenor, const double &swap_tenor, const double &fwd, const double &strike) const
+    {
+        if (this->vol_sabr != nullptr)
+        {
+            return this->vol_sabr->eval(tenor, fwd, strike);
+        }
+        else if (this->vol_cube != nullptr)
+        {
+            return this->vol_cube->eval({tenor, swap_tenor, strike});
+        }
+        return this->vol_surf->eval(tenor, strike);
+    }
+};
+
 // define volatility surface class
 class myVolSurface
 {
+    private:
+        // object function declarations
+        void load_vol_cube(const mySQLite &db, const std::string &sql_file_nm);
+        void load_vol_sabr(const mySQLite &db, const std::string &sql_file_nm);
+
     public:
         // object variables
         std::string vol_surf_nm;
@@ -116,6 +203,9 @@ class myVolSurface
         std::string vol_surf_type;
         std::string underlying;
         std::map<int, vol_surf_def> vol_surf; // map based on scenario number
+        std::map<int, myLinInterp2D> vol_surf_interp; // interpolation objects compiled at load; map based on scenario number
+        std::map<int, myGridInterp<double, 3>> vol_cube_interp; // volatility cubes of swaption_cube type compiled at load; map based on scenario number
+        std::map<int, mySabrInterp> vol_sabr_interp; // SABR parameters of sabr type; map based on scenario number
     
         // object constructors
         myVolSurface(const mySQLite &db, const std::string &sql_file_nm, const std::string &vol_surf_nm);
@@ -124,7 +214,15 @@ class myVolSurface
         ~myVolSurface(){};
 
         // object function declarations
+        bool is_vol_cube() const {return this->vol_surf_type.compare("swaption_cube") == 0;};
+        bool is_vol_sabr() const {return this->vol_surf_type.compare("sabr") == 0;};
+        vol_surf_handle get_vol_handle(const int &scn_no) const;
+        const myLinInterp2D &get_vol_surf_interp(const int &scn_no) const;
+        const myGridInterp<double, 3> &get_vol_cube_interp(const int &scn_no) const;
+        const mySabrInterp &get_vol_sabr_interp(const int &scn_no) const;
         std::vector<double> get_vols(const int &scn_no, const std::vector<double> &tenors, const std::vector<double> &strikes) const;
+        std::vector<double> get_vols(const int &scn_no, const std::vector<double> &tenors, const std::vector<double> &swap_tenors, const std::vector<double> &strikes) const;
+        void get_vols(const int &scn_no, const double * tenors, const double * swap_tenors, const double * strikes, double * vols, const int &values_no) const;
 };
 
 // define volatility surfaces class
@@ -141,5 +239,12 @@ class myVolSurfaces
         ~myVolSurfaces(){};
 
         // object function declarations
+        const myVolSurface &get_vol_surf(const std::string &vol_surf_nm) const;
+        vol_surf_handle get_vol_handle(const std::string &vol_surf_nm, const int &scn_no) const;
+        const myLinInterp2D &get_vol_surf_interp(const std::string &vol_surf_nm, const int &scn_no) const;
+        const myGridInterp<double, 3> &get_vol_cube_interp(const std::string &vol_surf_nm, const int &scn_no) const;
+        const mySabrInterp &get_vol_sabr_interp(const std::string &vol_surf_nm, const int &scn_no) const;
         std::vector<double> get_vols(const std::string &vol_surf_nm, const int &scn_no, const std::vector<double> &tenors, const std::vector<double> &strikes) const;
+        std::vector<double> get_vols(const std::string &vol_surf_nm, const int &scn_no, const std::vector<double> &tenors, const std::vector<double> &swap_tenors, const std::vector<double> &strikes) const;
+        void get_vols(const std::string &vol_surf_nm, const int &scn_no, const double * tenors, const double * swap_tenors, const double * strikes, double * vols, const int &values_no) const;
 };
@@ -121,4 +121,16 @@ std::vector<coordinates<int>> split_vector(const int &vector_length, const int &
 
 	// return vector with position indicies
 	return indicies;
-}
\ No newline at end of file
+}
+
+// calculate 64-bit FNV-1a hash of a string; the hash could be continued from a hash of preceding strings
+uint64_t calc_hash(const std::string &input_str, const uint64_t &hash)
+{
+	uint64_t hash_aux = hash;
+	for (long idx = 0; idx < input_str.size(); idx++)
+	{
+		hash_aux ^= static_cast<unsigned char>(input_str[idx]);
+		hash_aux *= 1099511628211ULL;
+	}
+	return hash_aux;
+}
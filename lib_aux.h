@@ -2,6 +2,7 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
 
 /*
 #include <iostream>
@@ -69,3 +70,6 @@ std::string get_datestamp();
 
 // split vector into several vectors of approximately same size => return indices which defines the new vectors
 std::vector<coordinates<int>> split_vector(const int &vector_length, const int &splits_no);
+
+// calculate 64-bit FNV-1a hash of a string; the hash could be continued from a hash of preceding strings
+uint64_t calc_hash(const std::string &input_str, const uint64_t &hash = 14695981039346656037ULL);
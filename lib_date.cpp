@@ -5,194 +5,273 @@
 #include <vector>
 #include <memory>
 #include <limits>
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
 #include "lib_date.h"
 
 /*
  * GENERAL FUNCTIONS
  */
 
-// determine number of days in month
-static int days_in_month(const int &year, const int &month)
-{
-    switch (month)
-    {
-        // months that have 31 days
-        case 1:
-        case 3:
-        case 5:
-        case 7:
-        case 8:
-        case 10:
-        case 12:
-            return 31;
-        // months that have 30 days
-        case 4:
-        case 6:
-        case 9:
-        case 11:
-            return 30;
-        // February
-        case 2:
-            if (year % 4 == 0)
-                return 29;
-            else
-                return 28;
-        // incorrect month
-        default:
-            throw std::invalid_argument((std::string)__func__ + ": " + std::to_string(month) + "  is not supported month!" );
+// parse date frequency string of (for example) "6M" into 6 and month tenor unit
+tenor_def parse_tenor(const std::string &freq)
+{
+    // check date frequency string
+    if (freq.size() < 2)
+    {
+        throw std::invalid_argument((std::string)__func__ + ": " + freq + " is not a supported date frequency!");
     }
-}
 
-// add months
-static int * add_months(const int &year, const int &month, const int &day, const int &months_to_add)
-{
-    // declare array of integers to hold information on year, month and day
-    static int date[3];
+    // determine number of frequency units
+    tenor_def tenor;
+    tenor.units_no = stoi(freq.substr(0, freq.size() - 1));
 
-    // individual date components
-    int _years_to_add;
-    int _year;
-    int _month;
-    int _day;
+    // determine frequency type
+    switch (freq.back())
+    {
+        case 'D':
+            tenor.unit = tenor_unit::day;
+            break;
+        case 'M':
+            tenor.unit = tenor_unit::month;
+            break;
+        case 'Y':
+            tenor.unit = tenor_unit::year;
+            break;
+        default:
+            throw std::invalid_argument((std::string)__func__ + ": " + freq.substr(freq.size() - 1, 1) + " is not supported date frequency type!");
+    }
 
-    // determine how many years and months should be added straight away
-    _years_to_add = months_to_add / 12;
-    _month = months_to_add % 12;
+    // return tenor
+    return tenor;
+}
 
-    // determine month
-    if ((_month > 0) && (_month + month) > 12)
+// translate business day adjustment convention name into business day adjustment convention
+bday_conv get_bday_conv(const std::string &conv_nm)
+{
+    if (conv_nm.compare("unadjusted") == 0)
     {
-        _years_to_add++;
-        _month = (_month + month) % 12;
+        return bday_conv::unadjusted;
+    }
+    else if (conv_nm.compare("following") == 0)
+    {
+        return bday_conv::following;
+    }
+    else if (conv_nm.compare("modified_following") == 0)
+    {
+        return bday_conv::modified_following;
+    }
+    else if (conv_nm.compare("preceding") == 0)
+    {
+        return bday_conv::preceding;
+    }
+    else if (conv_nm.compare("modified_preceding") == 0)
+    {
+        return bday_conv::modified_preceding;
     }
     else
     {
-        _month += month;
+        throw std::invalid_argument((std::string)__func__ + ": " + conv_nm + " is not a supported business day convention!");
     }
-
-    // determine year
-    _year = year + _years_to_add;
-
-    // check maximum day in month
-    _day = days_in_month(_year, _month);
-    if (day < _day)
-        _day = day;
-
-    // return result
-    date[0] = _year;
-    date[1] = _month;
-    date[2] = _day;
-
-    return date;
 }
 
-// remove months
-static int * remove_months(const int &year, const int &month, const int &day, const int &months_to_remove)
+// shift dates by a multiple of tenor; negative multiple shifts dates backward; shifted dates are written
+// into caller-provided buffer of the same size as vector of dates
+void shift_dates(const std::vector<myDate> &dates, const tenor_def &tenor, const int &tenors_no, myDate * shifted_dates)
 {
-    // declare array of integers to hold information on year, month and day
-    static int date[3];
-
-    // individual date components
-    int _years_to_remove;
-    int _year;
-    int _month;
-    int _day;
-
-    // determine how many years and months should be removed straight away
-    _years_to_remove = months_to_remove / 12;
-    _month = months_to_remove % 12;
-
-    // determine month
-    if ((_month > 0) && (month - _month) < 1)
+    for (int idx = 0; idx < dates.size(); idx++)
     {
-        _years_to_remove++;
-        _month = (12 + month - _month);
+        shifted_dates[idx] = dates[idx];
+        shifted_dates[idx].add(tenor, tenors_no);
     }
-    else
+}
+
+// create a vector of dates from start date to end date using time step of a given tenor
+std::vector<myDate> create_date_serie(const myDate &date_begin, const myDate &date_end, const tenor_def &tenor)
+{
+    // check tenor; the serie would never end otherwise
+    if (tenor.units_no <= 0)
     {
-        _month = month - _month;
+        throw std::invalid_argument((std::string)__func__ + ": Tenor must be positive!");
     }
 
-    // determine year
-    _year = year - _years_to_remove;
-
-    // check maximum day in month
-    _day = days_in_month(_year, _month);
-    if (day < _day)
-        _day = day;
+    // create vector to hold date serie
+    std::vector<myDate> date_serie;
 
-    // return result
-    date[0] = _year;
-    date[1] = _month;
-    date[2] = _day;
+    // create date series
+    myDate date_current = date_begin;
+    while (date_current.get_days_no() <= date_end.get_days_no())
+    {
+        date_serie.push_back(date_current);
+        date_current.add(tenor);
+    }
 
-    return date;
+    // return vector with date serie
+    return date_serie;
 }
 
-// decompose date frequency of (for example) "6M" into 6 and "M"
-static std::tuple<int, std::string> decompose_freq(const std::string &freq)
+// cache of date series shared by contracts with the same anchor date, end date and tenor; the cache is bounded,
+// once it holds date_serie_cache_size_max date series it is flushed before the next date serie is stored
+static std::map<std::tuple<int, int, int, int>, date_serie_ptr> date_serie_cache;
+static std::shared_mutex date_serie_cache_mutex;
+static const size_t date_serie_cache_size_max = 65536;
+
+// get date serie from start date to end date using time step of a given tenor; date series are memoized so
+// that contracts with identical schedules share a single read-only date serie
+date_serie_ptr get_date_serie(const myDate &date_begin, const myDate &date_end, const tenor_def &tenor)
 {
-   // variables to hold frequency type (e.g. D, M, Y) and number of frequency units
-   int freq_no;
-   std::string freq_type; 
+    std::tuple<int, int, int, int> key(date_begin.get_days_no(), date_end.get_days_no(), tenor.units_no, static_cast<int>(tenor.unit));
 
-   // determine frequency units
-   freq_no = stoi(freq.substr(0, freq.size() - 1));
+    // look for already created date serie
+    {
+        std::shared_lock<std::shared_mutex> lock(date_serie_cache_mutex);
+        auto it = date_serie_cache.find(key);
+        if (it != date_serie_cache.end())
+        {
+            return it->second;
+        }
+    }
 
-   // determine frequency type
-   freq_type = freq.substr(freq.size() - 1, 1);
+    // create date serie outside of the lock; if another thread was faster, its date serie is used
+    date_serie_ptr date_serie = std::make_shared<const std::vector<myDate>>(create_date_serie(date_begin, date_end, tenor));
+    std::unique_lock<std::shared_mutex> lock(date_serie_cache_mutex);
+    if (date_serie_cache.size() >= date_serie_cache_size_max)
+    {
+        date_serie_cache.clear();
+    }
+    return date_serie_cache.emplace(key, date_serie).first->second;
+}
 
-   // return number of frequency units and frequency type
-   return {freq_no, freq_type};
- }
+// cache of date series adjusted to business days; calendars are identified by their names; the cache is bounded
+// in the same way as the cache of unadjusted date series
+static std::map<std::tuple<int, int, int, int, std::string, int>, date_serie_ptr> adj_date_serie_cache;
 
-// create a vector of dates from start date to end date using time step of a given frequency
-std::vector<myDate> create_date_serie(const std::string &date_str_begin, const std::string &date_str_end, const std::string &date_freq, const std::string &date_format)
+// get date serie from start date to end date using time step of a given tenor with dates adjusted to business
+// days of a given calendar; adjusted date series are memoized as well
+date_serie_ptr get_date_serie(const myDate &date_begin, const myDate &date_end, const tenor_def &tenor, const myCalendar &cal, const bday_conv &conv)
 {
-    // create vector to hold date serie
-    std::vector<myDate> date_serie;
+    std::tuple<int, int, int, int, std::string, int> key(date_begin.get_days_no(), date_end.get_days_no(), tenor.units_no, static_cast<int>(tenor.unit), cal.get_cal_nm(), static_cast<int>(conv));
 
-    //create date end and current date objects
-    myDate date_end(date_str_end, date_format);
-    myDate date_current(date_str_begin, date_format);
+    // look for already adjusted date serie
+    {
+        std::shared_lock<std::shared_mutex> lock(date_serie_cache_mutex);
+        auto it = adj_date_serie_cache.find(key);
+        if (it != adj_date_serie_cache.end())
+        {
+            return it->second;
+        }
+    }
 
-    // create date series
-    while (date_current.get_date_int() <= date_end.get_date_int())
+    // adjust unadjusted date serie
+    date_serie_ptr date_serie = get_date_serie(date_begin, date_end, tenor);
+    std::vector<myDate> adj_date_serie(date_serie->size());
+    cal.adjust(*date_serie, conv, adj_date_serie.data());
+
+    // store adjusted date serie
+    date_serie_ptr adj_date_serie_ptr = std::make_shared<const std::vector<myDate>>(std::move(adj_date_serie));
+    std::unique_lock<std::shared_mutex> lock(date_serie_cache_mutex);
+    if (adj_date_serie_cache.size() >= date_serie_cache_size_max)
     {
-        date_serie.push_back(date_current);
-        date_current.add(date_freq);
+        adj_date_serie_cache.clear();
     }
+    return adj_date_serie_cache.emplace(key, adj_date_serie_ptr).first->second;
+}
 
-    // return vector with date serie
-    return date_serie;
+// release memoized date series, e.g. once all portfolios of a calculation date are loaded; this is the reset point
+// of the caches, which are not evicted otherwise until they are full; date series still used by contracts are kept
+// alive by their shared pointers
+void clear_date_serie_cache()
+{
+    std::unique_lock<std::shared_mutex> lock(date_serie_cache_mutex);
+    date_serie_cache.clear();
+    adj_date_serie_cache.clear();
+}
+
+// create a vector of dates from start date to end date using time step of a given frequency
+std::vector<myDate> create_date_serie(const std::string &date_str_begin, const std::string &date_str_end, const std::string &date_freq, const std::string &date_format)
+{
+    return create_date_serie(myDate(date_str_begin, date_format), myDate(date_str_end, date_format), parse_tenor(date_freq));
 }
 
 // convert date frequency string into approximate year fraction; could
 // be used to compare individual date frequencies
 double eval_freq(const std::string &freq)
 {
-    // split frequency string into number of frequency units and frequency type
-    int freq_no;
-    std::string freq_type;
-    std::tie(freq_no, freq_type) = decompose_freq(freq);   
+    // parse frequency string into number of frequency units and frequency type
+    tenor_def tenor = parse_tenor(freq);
 
     // calculate approximate year fraction representing given frequency
     // string
-    if (freq_type.compare("D") == 0)
+    if (tenor.unit == tenor_unit::day)
     {
-        return freq_no / 365.25;
+        return tenor.units_no / 365.25;
     }
-    else if (freq_type.compare("M") == 0)
+    else if (tenor.unit == tenor_unit::month)
     {
-        return 30.438 * freq_no / 365.25;
+        return 30.438 * tenor.units_no / 365.25;
     }
-    else if (freq_type.compare("Y") == 0)
+    else
     {
-        return freq_no;
+        return tenor.units_no;
     }
-    else
+}
+
+// match dates to target dates in a single merge pass; both vectors are supposed to be sorted in ascending
+// order. Index of the matched target date is written into caller-provided buffer of the same size as vector
+// of dates, -1 if there is no matching date; if there are several equal target dates, the first one is used
+void match_dates(const std::vector<myDate> &dates, const std::vector<myDate> &target_dates, const date_match &rule, int * idxs)
+{
+    // check that there are target dates to match
+    if ((dates.size() > 0) && (target_dates.size() == 0))
     {
-        throw std::runtime_error((std::string)__func__ + ": unsupported date frequency type " + freq_type + "!");
+        throw std::runtime_error((std::string)__func__ + ": No target dates to match!");
+    }
+
+    // index of the last target date on or before the current date and index of the first target date
+    // equal to it; -1 if there is no such target date
+    int prev_idx = -1;
+    int prev_first_idx = -1;
+
+    // go date by date
+    for (int idx = 0; idx < dates.size(); idx++)
+    {
+        // move forward through target dates not exceeding the current date
+        int days_no = dates[idx].get_days_no();
+        while ((prev_idx + 1 < target_dates.size()) && (target_dates[prev_idx + 1].get_days_no() <= days_no))
+        {
+            prev_idx++;
+            if ((prev_first_idx < 0) || (target_dates[prev_idx].get_days_no() != target_dates[prev_first_idx].get_days_no()))
+            {
+                prev_first_idx = prev_idx;
+            }
+        }
+
+        // candidate target dates on or before and on or after the current date
+        int next_idx = (prev_idx + 1 < target_dates.size()) ? prev_idx + 1 : -1;
+        if ((prev_first_idx >= 0) && (target_dates[prev_first_idx].get_days_no() == days_no))
+        {
+            next_idx = prev_first_idx;
+        }
+
+        // match dates
+        if (rule == date_match::previous)
+        {
+            idxs[idx] = prev_first_idx;
+        }
+        else if (rule == date_match::next)
+        {
+            idxs[idx] = next_idx;
+        }
+        else if ((prev_first_idx < 0) || (next_idx < 0))
+        {
+            idxs[idx] = (prev_first_idx < 0) ? next_idx : prev_first_idx;
+        }
+        else
+        {
+            idxs[idx] = (days_no - target_dates[prev_first_idx].get_days_no() <= target_dates[next_idx].get_days_no() - days_no) ? prev_first_idx : next_idx;
+        }
     }
 }
 
@@ -272,252 +351,186 @@ int get_nearest_idx(const myDate &date, const std::vector<myDate> &dates, const
  * OBJECT FUNCTIONS
  */
 
-// set year, month and day based on date std::string in yyyymmdd format
-void myDate::set_year_month_day()
+// set year, month and day based on date integer in yyyymmdd format
+void myDate::set_date_int(const int &date_int)
 {
     // determine year, month and day
-    year = stoi(date_str.substr(0, 4));
-    month = stoi(date_str.substr(4, 2));
-    day = stoi(date_str.substr(6,2));
+    this->year = date_int / 10000;
+    this->month = (date_int / 100) % 100;
+    this->day = date_int % 100;
 }
 
 // derive date "distance" in days from initial date of 01/01/1601
 void myDate::set_days_no()
 {
-    // calculate number of days for initial date
-        // years contribution
-        days_no = (year - init_year) * 365;
-        days_no += (year - init_year) / 4; // leap years
-        days_no -= (year - init_year) / 100; // we skip leap years every 100 years
-        days_no += (year - init_year) / 400; // unless the year is divisible by 400
-        // months contribution
-        for (int i = month - 1; i > 0; --i)
-        {
-            days_no += days_in_month(year, i);
-        }
-        // days contribution
-        days_no += day - 1;
+    this->days_no = calc_days_no(this->year, this->month, this->day);
 }
 
-// update date integer, year, month and day based on date std::string in format yyyymmdd
+// update number of days since 01/01/1601 based on year, month and day
 void myDate::recalc()
 {
-    // convert yyyymmdd date std::string into integer
-    date_int = stoi(date_str);
-
-    // set year, month and day
-    this->set_year_month_day();
-
-    // set days_no
     this->set_days_no();
 }
 
-//shift date forward using specified date frequency (e.g. 2D, 3M, 10Y)
-void myDate::add(const std::string &date_freq)
+// shift date forward by a given number of days
+void myDate::add_days(const int &days_no)
 {
-    // variables to hold frequency type (e.g. D, M, Y) and number of frequency units
-    int date_freq_no;
-    std::string date_freq_type;
-    std::tie(date_freq_no, date_freq_type) = decompose_freq(date_freq); 
-
-    if (date_freq_type.compare("D") == 0)
-    {
-        int _days_no;
-        int _years_to_add;
-        int _months_to_add;
-        int _days_in_month;
-        std::string _freq_date;
-
-        // store number of days in the current date
-        _days_no = this->days_no;
-
-        // add years to the current days
-        _years_to_add = date_freq_no / 366;
-        if (_years_to_add != 0)
-        {
-            _days_no = this->get_days_no();
-            _freq_date = std::to_string(_years_to_add) + "Y";
-            this->add(_freq_date);
-            date_freq_no -= this->days_no - _days_no;
-        }
+    this->days_no += days_no;
+    this->set_date_int(calc_date_int(this->days_no));
+}
 
-        // add months in bulk
-        _months_to_add = date_freq_no / 31;
-        if (_months_to_add != 0)
-        {
-            _days_no = this->get_days_no();
-            _freq_date = std::to_string(_months_to_add) + "M";
-            this->add(_freq_date);
-            date_freq_no -= this->days_no - _days_no;
-        }
+// shift date forward by a given number of months; the day is capped by the last day of the resulting month
+void myDate::add_months(const int &months_no)
+{
+    // months since the beginning of year 0
+    int months = this->year * 12 + (this->month - 1) + months_no;
 
-        // add the last one or two months
-        _days_in_month = days_in_month(this->year, this->month);
-        while (date_freq_no + this->day > _days_in_month)
-        {
-            _days_no = this->get_days_no();
-            _freq_date = "1M";
-            this->add(_freq_date);
-            date_freq_no -= this->days_no - _days_no;
-            _days_in_month = days_in_month(this->year, this->month);
-        }
-        
-        // add remaining days
-        this->day += date_freq_no;
-        this->date_str = std::to_string(this->year * 10000 + this->month * 100 + this->day);
-        this->recalc();
+    // determine year, month and day
+    this->year = months / 12;
+    this->month = months % 12 + 1;
+    this->day = std::min(static_cast<int>(this->day), days_in_month(this->year, this->month));
+    this->set_days_no();
+}
 
-    }
-    else if (date_freq_type.compare("M") == 0)
+// shift date forward by a multiple of tenor; years are shifted as 12 months
+void myDate::add(const tenor_def &tenor, const int &tenors_no)
+{
+    if (tenor.unit == tenor_unit::day)
     {
-        int * date;
-        date = add_months(this->year, this->month, this->day, date_freq_no);
-        this->year = date[0];
-        this->month = date[1];
-        this->day = date[2];
-        this->date_str = std::to_string(this->year * 10000 + this->month * 100 + this->day);
-        this->recalc();
+        this->add_days(tenor.units_no * tenors_no);
     }
-    else if (date_freq_type.compare("Y") == 0)
+    else if (tenor.unit == tenor_unit::month)
     {
-        this->year += date_freq_no;
-        this->date_str = std::to_string(this->year * 10000 + this->month * 100 + this->day);
-        this->recalc();
+        this->add_months(tenor.units_no * tenors_no);
     }
     else
     {
-        throw std::invalid_argument((std::string)__func__ + ": " + date_freq_type + " is  notsupported date date frequency type!");
+        this->add_months(12 * tenor.units_no * tenors_no);
     }
 }
 
+// shift date backward by a multiple of tenor
+void myDate::remove(const tenor_def &tenor, const int &tenors_no)
+{
+    this->add(tenor, -tenors_no);
+}
+
 //shift date forward using specified date frequency (e.g. 2D, 3M, 10Y)
-void myDate::remove(const std::string &date_freq)
+void myDate::add(const std::string &date_freq)
 {
-    // variables to hold frequency type (e.g. D, M, Y) and number of frequency units
-    int date_freq_no;
-    std::string date_freq_type;
+    this->add(parse_tenor(date_freq));
+}
 
-    tie(date_freq_no, date_freq_type) = decompose_freq(date_freq);
+//shift date backward using specified date frequency (e.g. 2D, 3M, 10Y)
+void myDate::remove(const std::string &date_freq)
+{
+    this->remove(parse_tenor(date_freq));
+}
 
-    if (date_freq_type.compare("D") == 0)
-    {
-        int _days_no;
-        int _years_to_remove;
-        int _months_to_remove;
-        int _days_in_month;
-        std::string _freq_date;
+bool myDate::is_last_day_in_month() const
+{
+    return this->day == days_in_month(this->year, this->month);
+}
 
-        // store number of days in the current date
-        _days_no = this->days_no;
+bool myDate::is_leap_year() const
+{
+    return ::is_leap_year(this->get_year());
+}
 
-        // remove years from the current days
-        _years_to_remove = date_freq_no / 365;
-        if (_years_to_remove != 0)
-        {
-            _days_no = this->get_days_no();
-            _freq_date = std::to_string(_years_to_remove) + "Y";
-            this->remove(_freq_date);
-            date_freq_no -= _days_no - this->days_no;
-        }
+// check that date is covered by calendar and return its position in bitset of business days
+int myCalendar::check_days_no(const myDate &date) const
+{
+    if ((date.get_days_no() < this->days_no_first) || (date.get_days_no() > this->days_no_last))
+    {
+        throw std::out_of_range((std::string)__func__ + ": Date " + date.get_date_str() + " is not covered by calendar " + this->cal_nm + "!");
+    }
+    return date.get_days_no() - this->days_no_first;
+}
 
-        // remove months in bulk
-        _months_to_remove = date_freq_no / 30;
-        if (_months_to_remove != 0)
+// find the first business day on or after a given position in bitset of business days
+int myCalendar::get_next_bday(const int &days_no) const
+{
+    int word = days_no >> 6;
+    uint64_t bits = this->bdays[word] & (~0ULL << (days_no & 63));
+    while (bits == 0)
+    {
+        if (++word >= this->bdays.size())
         {
-            _days_no = this->get_days_no();
-            _freq_date = std::to_string(_months_to_remove) + "M";
-            this->remove(_freq_date);
-            date_freq_no -= _days_no - this->days_no;
+            throw std::out_of_range((std::string)__func__ + ": No business day found till the end of calendar " + this->cal_nm + "!");
         }
+        bits = this->bdays[word];
+    }
+    return (word << 6) + __builtin_ctzll(bits);
+}
 
-        // remove the last one or two months
-        while (this->day - date_freq_no < 0)
+// find the first business day on or before a given position in bitset of business days
+int myCalendar::get_prev_bday(const int &days_no) const
+{
+    int word = days_no >> 6;
+    uint64_t bits = this->bdays[word] & (~0ULL >> (63 - (days_no & 63)));
+    while (bits == 0)
+    {
+        if (--word < 0)
         {
-            date_freq_no -= this->day;
-            this->month--;
-            _days_in_month = days_in_month(this->year, this->month);
-            this->day = _days_in_month;
-            if (this->month < 0)
-            {
-                this->year--;
-                this->month += 12;
-            }
-            this->date_str = std::to_string(this->year * 10000 + this->month * 100 + this->day);
-            this->recalc();
+            throw std::out_of_range((std::string)__func__ + ": No business day found till the beginning of calendar " + this->cal_nm + "!");
         }
-        this->day -= date_freq_no;
-        this->date_str = std::to_string(this->year * 10000 + this->month * 100 + this->day);
-        this->recalc();            
-    }
-    else if (date_freq_type.compare("M") == 0)
-    {
-        int * date;
-        date = remove_months(this->year, this->month, this->day, date_freq_no);
-        this->year = date[0];
-        this->month = date[1];
-        this->day = date[2];
-        this->date_str = std::to_string(this->year * 10000 + this->month * 100 + this->day);
-        this->recalc();
-    }
-    else if (date_freq_type.compare("Y") == 0)
-    {
-        year -= date_freq_no;
-        this->date_str = std::to_string(this->year * 10000 + this->month * 100 + this->day);
-        this->recalc();
-    }
-    else
-    {
-        throw std::invalid_argument((std::string)__func__ + ": " + date_freq_type + " is  notsupported date date frequency type!");
+        bits = this->bdays[word];
     }
+    return (word << 6) + 63 - __builtin_clzll(bits);
 }
 
-bool myDate::is_last_day_in_month() const
+// check if date is a business day
+bool myCalendar::is_business_day(const myDate &date) const
 {
-    // copy myDate object into an auxiliary variable
-    myDate date_aux = myDate(this->get_date_int());
-
-    // store the current month into an auxiliary variable
-    int month_aux = date_aux.get_month();
+    int days_no = this->check_days_no(date);
+    return (this->bdays[days_no >> 6] >> (days_no & 63)) & 1;
+}
 
-    // add one date to the date
-    date_aux.add("1D");
+// adjust date to business day using business day adjustment convention
+myDate myCalendar::adjust(const myDate &date, const bday_conv &conv) const
+{
+    // position of date in bitset of business days
+    int days_no = this->check_days_no(date);
+    int adj_days_no = days_no;
 
-    // check if the month has changed
-    if (date_aux.get_month() > month_aux){
-        return true;
+    // adjust date
+    if ((conv == bday_conv::following) || (conv == bday_conv::modified_following))
+    {
+        adj_days_no = this->get_next_bday(days_no);
     }
-    else
+    else if ((conv == bday_conv::preceding) || (conv == bday_conv::modified_preceding))
     {
-        return false;
+        adj_days_no = this->get_prev_bday(days_no);
     }
-}
 
-bool myDate::is_leap_year() const
-{
-    // variables
-    bool is_leap = false;
-    int year = this->get_year();
+    // shift date
+    myDate adj_date = date;
+    adj_date.add_days(adj_days_no - days_no);
 
-    // the most common defintion of a leap year is divisibility by 4
-    if (year % 4 == 0)
+    // modified conventions do not allow adjusted date to fall into another month
+    if ((conv == bday_conv::modified_following) && (adj_date.get_month() != date.get_month()))
     {
-        is_leap = true;
+        adj_date = date;
+        adj_date.add_days(this->get_prev_bday(days_no) - days_no);
     }
-
-    // however we skip leap year every 100 years
-    if (year % 100 == 0)
+    else if ((conv == bday_conv::modified_preceding) && (adj_date.get_month() != date.get_month()))
     {
-        is_leap = false;
+        adj_date = date;
+        adj_date.add_days(this->get_next_bday(days_no) - days_no);
     }
 
-    // unless the year is not divisible by 400
-    if (year % 400 == 0)
+    // return adjusted date
+    return adj_date;
+}
+
+// adjust dates to business days using business day adjustment convention; adjusted dates are written into
+// caller-provided buffer of the same size as vector of dates
+void myCalendar::adjust(const std::vector<myDate> &dates, const bday_conv &conv, myDate * adjusted_dates) const
+{
+    for (int idx = 0; idx < dates.size(); idx++)
     {
-        is_leap = false;
+        adjusted_dates[idx] = this->adjust(dates[idx], conv);
     }
-
-    // return information if the year is leap year or not
-    return is_leap;
 }
 
 /*
@@ -526,32 +539,29 @@ bool myDate::is_leap_year() const
 
 myDate::myDate()
 {
-    date_str = "16010101";
-    date_int = 16010101;
-    year = 1601;
-    month = 1;
-    day = 1;
-    days_no = 0;
+    this->set_date_int(16010101);
+    this->days_no = 0;
 };
 
 myDate::myDate(const std::string &date_str, const std::string &date_format)
 {
     // convert date std::string into yyyymmdd string format
+    std::string _date_str;
     if (date_format.compare("dd/mm/yyyy") == 0)
     {
-        this->date_str = date_str.substr(6,4) + date_str.substr(3,2) + date_str.substr(0, 2);
+        _date_str = date_str.substr(6,4) + date_str.substr(3,2) + date_str.substr(0, 2);
     }
     else if (date_format.compare("yyyy/mm/dd") == 0)
     {
-        this->date_str = date_str.substr(0,4) + date_str.substr(5,2) + date_str.substr(8, 2);
+        _date_str = date_str.substr(0,4) + date_str.substr(5,2) + date_str.substr(8, 2);
     }
     else if (date_format.compare("ddmmyyyy") == 0)
     {
-        this->date_str = date_str.substr(4, 4) + date_str.substr(2, 2) + date_str.substr(0, 2);
+        _date_str = date_str.substr(4, 4) + date_str.substr(2, 2) + date_str.substr(0, 2);
     }
     else if (date_format.compare("yyyymmdd") == 0)
     {
-        this->date_str = date_str;
+        _date_str = date_str;
     }
     else
     {
@@ -559,45 +569,92 @@ myDate::myDate(const std::string &date_str, const std::string &date_format)
     }
 
     // determine year, month, day and number of days since 01/01/1601
-    this->recalc();
-
+    this->set_date_int(stoi(_date_str));
+    this->set_days_no();
 }
 
 myDate::myDate(const int &date_int)
 {
-    // store date integer; we assume yyyymmdd format
-    this->date_int = date_int;
-
-    // store date as std::string in yyyymmdd
-    this->date_str = std::to_string(date_int);
-
-    // determine year, month, day and number of days since 01/01/1601
-    this->recalc();
+    // determine year, month, day and number of days since 01/01/1601; we assume yyyymmdd format
+    this->set_date_int(date_int);
+    this->set_days_no();
 }
 
-/*
- * COPY CONSTRUCTOR
- */
-
-myDate::myDate (const myDate &date)
+// holiday calendar covering years year_first, ..., year_last; holidays are given as date integers in yyyymmdd
+// format and weekends are treated as non-business days unless stated otherwise
+myCalendar::myCalendar(const std::string &cal_nm, const std::vector<int> &holidays, const bool &weekends, const int &year_first, const int &year_last)
 {
-    this->date_str = date.get_date_str();
-    this->recalc();
-};
+    // check calendar range
+    if ((year_first < 1601) || (year_last < year_first))
+    {
+        throw std::invalid_argument((std::string)__func__ + ": Calendar " + cal_nm + " has incorrect range of years!");
+    }
 
-/*
- * OBJECT OPERATORS
- */
+    // calendar range
+    this->cal_nm = cal_nm;
+    this->days_no_first = calc_days_no(year_first, 1, 1);
+    this->days_no_last = calc_days_no(year_last, 12, 31);
+    int days_no = this->days_no_last - this->days_no_first + 1;
+    this->bdays.assign((days_no + 63) / 64, 0);
 
-long myDate::operator- (const myDate &date2)
-{
-    return days_no - date2.get_days_no();
+    // mark business days; 01/01/1601 was Monday
+    for (int idx = 0; idx < days_no; idx++)
+    {
+        int weekday = (this->days_no_first + idx) % 7; // 0 stands for Monday
+        if (!weekends || (weekday < 5))
+        {
+            this->bdays[idx >> 6] |= 1ULL << (idx & 63);
+        }
+    }
+
+    // unmark holidays; holidays outside calendar range are ignored
+    for (int idx = 0; idx < holidays.size(); idx++)
+    {
+        long holiday = calc_days_no(holidays[idx]) - this->days_no_first;
+        if ((holiday >= 0) && (holiday < days_no))
+        {
+            this->bdays[holiday >> 6] &= ~(1ULL << (holiday & 63));
+        }
+    }
 }
 
-myDate& myDate::operator= (const myDate &date)
+// joint holiday calendar; a day is a business day only if it is a business day in all the calendars
+myCalendar::myCalendar(const std::string &cal_nm, const std::vector<myCalendar> &cals)
 {
-    this->date_str = date.get_date_str();
-    this->recalc();
-    return *this;
-};
+    // check calendars
+    if (cals.size() == 0)
+    {
+        throw std::invalid_argument((std::string)__func__ + ": Joint calendar " + cal_nm + " requires at least one calendar!");
+    }
 
+    // joint calendar covers range common to all the calendars
+    this->cal_nm = cal_nm;
+    this->days_no_first = cals[0].days_no_first;
+    this->days_no_last = cals[0].days_no_last;
+    for (int idx = 1; idx < cals.size(); idx++)
+    {
+        this->days_no_first = std::max(this->days_no_first, cals[idx].days_no_first);
+        this->days_no_last = std::min(this->days_no_last, cals[idx].days_no_last);
+    }
+    if (this->days_no_last < this->days_no_first)
+    {
+        throw std::invalid_argument((std::string)__func__ + ": Calendars of joint calendar " + cal_nm + " do not overlap!");
+    }
+
+    // intersection of business days
+    int days_no = this->days_no_last - this->days_no_first + 1;
+    this->bdays.assign((days_no + 63) / 64, 0);
+    for (int idx = 0; idx < days_no; idx++)
+    {
+        bool is_bday = true;
+        for (int cal_idx = 0; (cal_idx < cals.size()) && is_bday; cal_idx++)
+        {
+            int cal_days_no = this->days_no_first + idx - cals[cal_idx].days_no_first;
+            is_bday = (cals[cal_idx].bdays[cal_days_no >> 6] >> (cal_days_no & 63)) & 1;
+        }
+        if (is_bday)
+        {
+            this->bdays[idx >> 6] |= 1ULL << (idx & 63);
+        }
+    }
+}
@@ -70,22 +70,149 @@ int main()
 #include <string>
 #include <tuple>
 #include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <memory>
 
-// define date class
+// number of days preceeding a given month in a non-leap year
+constexpr int cum_days_in_month[13] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365};
+
+// determine if a year is a leap year by Gregorian rules, i.e. divisible by 4 but not by 100 unless it is divisible
+// by 400
+constexpr bool is_leap_year(const int &year)
+{
+    return ((year % 4 == 0) && (year % 100 != 0)) || (year % 400 == 0);
+}
+
+// determine number of days in month
+constexpr int days_in_month(const int &year, const int &month)
+{
+    // check month
+    if ((month < 1) || (month > 12))
+    {
+        throw std::invalid_argument((std::string)__func__ + ": " + std::to_string(month) + "  is not supported month!" );
+    }
+
+    // February of a leap year
+    if ((month == 2) && is_leap_year(year))
+    {
+        return 29;
+    }
+
+    // other months
+    return cum_days_in_month[month] - cum_days_in_month[month - 1];
+}
+
+// derive date "distance" in days from initial date of 01/01/1601 without
+// constructing myDate object
+constexpr long calc_days_no(const int &year, const int &month, const int &day)
+{
+    // initial year of the calendar
+    constexpr int init_year = 1601;
+
+    // check month
+    if ((month < 1) || (month > 12))
+    {
+        throw std::invalid_argument((std::string)__func__ + ": " + std::to_string(month) + "  is not supported month!" );
+    }
+
+    // years contribution
+    long days_no = (year - init_year) * 365L;
+    days_no += (year - init_year) / 4; // leap years
+    days_no -= (year - init_year) / 100; // we skip leap years every 100 years
+    days_no += (year - init_year) / 400; // unless the year is divisible by 400
+
+    // months contribution
+    days_no += cum_days_in_month[month - 1];
+    if ((month > 2) && is_leap_year(year))
+    {
+        days_no++;
+    }
+
+    // days contribution
+    days_no += day - 1;
+
+    // return number of days
+    return days_no;
+}
+
+// derive date "distance" in days from initial date of 01/01/1601 based on date
+// integer in yyyymmdd format
+constexpr long calc_days_no(const int &date_int)
+{
+    return calc_days_no(date_int / 10000, (date_int / 100) % 100, date_int % 100);
+}
+
+// derive date integer in yyyymmdd format from number of days since 01/01/1601;
+// inverse of calc_days_no() for dates from 01/01/1601 onwards
+constexpr int calc_date_int(const long &days_no)
+{
+    // check that the date is not before the initial date of the calendar
+    if (days_no < 0)
+    {
+        throw std::invalid_argument((std::string)__func__ + ": " + std::to_string(days_no) + " days precedes 01/01/1601!");
+    }
+
+    // whole 400, 100, 4 and 1 year periods; 01/01/1601 starts a 400 year cycle
+    long days = days_no;
+    int year = 1601 + 400 * (int)(days / 146097);
+    days %= 146097;
+    int centuries = (int)(days / 36524) < 3 ? (int)(days / 36524) : 3;
+    days -= centuries * 36524L;
+    int quads = (int)(days / 1461);
+    days -= quads * 1461L;
+    int years = (int)(days / 365) < 3 ? (int)(days / 365) : 3;
+    days -= years * 365L;
+    year += 100 * centuries + 4 * quads + years;
+
+    // month and day
+    int leap = is_leap_year(year) ? 1 : 0;
+    int month = 1;
+    while ((month < 12) && (days >= cum_days_in_month[month] + ((month >= 2) ? leap : 0)))
+    {
+        month++;
+    }
+    int day = (int)days - cum_days_in_month[month - 1] - ((month > 2) ? leap : 0) + 1;
+
+    // return date integer
+    return year * 10000 + month * 100 + day;
+}
+
+// serial and civil dates are converted exactly, including century years
+static_assert(calc_days_no(21010101) - calc_days_no(21001231) == 1, "31/12/2100 and 01/01/2101 must be consecutive days");
+static_assert(calc_date_int(calc_days_no(21000228) + 1) == 21000301, "2100 is not a leap year");
+static_assert(calc_date_int(calc_days_no(20000228) + 1) == 20000229, "2000 is a leap year");
+
+// units of date tenor
+enum class tenor_unit : int8_t
+{
+    day,
+    month,
+    year
+};
+
+// compact date tenor (e.g. 2D, 3M, 10Y); date frequency strings are parsed into tenors
+// only once so that dates can be shifted without any string manipulation
+struct tenor_def
+{
+    int32_t units_no = 0; // number of tenor units
+    tenor_unit unit = tenor_unit::day; // tenor unit
+};
+
+// define date class; the date is a compact trivially copyable value of 8 bytes, date
+// string is created only on demand
 class myDate
 {
     private:
         // variables
-        std::string date_str;
-        int date_int;
-        int year;
-        int month;
-        int day;
-        long days_no;
-        const int init_year = 1601;
+        int32_t days_no;
+        int16_t year;
+        int8_t month;
+        int8_t day;
 
         // functions
-        void set_year_month_day();
+        void set_date_int(const int &date_int);
         void set_days_no();
 
     public:
@@ -94,15 +221,11 @@ class myDate
         myDate(const std::string &date_str, const std::string &date_format);
         myDate(const int &date_int);
 
-        // copy constructor
-        myDate (const myDate &date);
-
         // object destructor
-        ~myDate(){};
+        ~myDate() = default;
 
         // overloaded operators
-        long operator- (const myDate &date2);
-        myDate& operator= (const myDate &_date);
+        long operator- (const myDate &date2) const {return days_no - date2.days_no;}
 
         // object function declarations
         void recalc();
@@ -110,15 +233,82 @@ class myDate
         int get_month() const {return month;}
         int get_day() const {return day;}
         int get_days_no() const {return days_no;}
-        int get_date_int() const {return date_int;}
-        std::string get_date_str() const {return date_str;}
+        int get_date_int() const {return year * 10000 + month * 100 + day;}
+        std::string get_date_str() const {return std::to_string(this->get_date_int());}
         void add(const std::string &date_freq);
+        void add(const tenor_def &tenor, const int &tenors_no = 1);
+        void add_days(const int &days_no);
+        void add_months(const int &months_no);
         void remove(const std::string &date_freq);
+        void remove(const tenor_def &tenor, const int &tenors_no = 1);
         bool is_last_day_in_month() const;
         bool is_leap_year() const;
 };
 
+// dates are copied by event vectors and curve tables; keep them cheap to copy
+static_assert(std::is_trivially_copyable<myDate>::value, "myDate must be trivially copyable");
+
+// shared read-only date serie
+typedef std::shared_ptr<const std::vector<myDate>> date_serie_ptr;
+
+// business day adjustment conventions
+enum class bday_conv
+{
+    unadjusted, // date is not adjusted
+    following, // the first business day following the date
+    modified_following, // the first business day following the date unless it falls into the next month
+    preceding, // the first business day preceeding the date
+    modified_preceding // the first business day preceeding the date unless it falls into the previous month
+};
+
+// rules of matching dates to dates of another date serie
+enum class date_match
+{
+    nearest, // the nearest date; the earlier date in case of a tie
+    previous, // the nearest date on or before the date
+    next // the nearest date on or after the date
+};
+
+// define holiday calendar; business days over the supported date range are precomputed as a bitset so that
+// checking and adjusting a date are just a few bit operations
+class myCalendar
+{
+    private:
+        // variables
+        std::string cal_nm;
+        int days_no_first; // the first day covered by calendar in days since 01/01/1601
+        int days_no_last; // the last day covered by calendar in days since 01/01/1601
+        std::vector<uint64_t> bdays; // bitset of business days
+
+        // functions
+        int check_days_no(const myDate &date) const;
+        int get_next_bday(const int &days_no) const;
+        int get_prev_bday(const int &days_no) const;
+
+    public:
+        // object constructors
+        myCalendar(const std::string &cal_nm, const std::vector<int> &holidays, const bool &weekends = true, const int &year_first = 1901, const int &year_last = 2199);
+        myCalendar(const std::string &cal_nm, const std::vector<myCalendar> &cals);
+
+        // object destructor
+        ~myCalendar(){};
+
+        // object function declarations
+        std::string get_cal_nm() const {return cal_nm;}
+        bool is_business_day(const myDate &date) const;
+        myDate adjust(const myDate &date, const bday_conv &conv) const;
+        void adjust(const std::vector<myDate> &dates, const bday_conv &conv, myDate * adjusted_dates) const;
+};
+
 // external functions
+tenor_def parse_tenor(const std::string &freq);
+bday_conv get_bday_conv(const std::string &conv_nm);
+void shift_dates(const std::vector<myDate> &dates, const tenor_def &tenor, const int &tenors_no, myDate * shifted_dates);
+std::vector<myDate> create_date_serie(const myDate &date_begin, const myDate &date_end, const tenor_def &tenor);
 std::vector<myDate> create_date_serie(const std::string &date_str_begin, const std::string &date_str_end, const std::string &date_freq, const std::string &date_format);
+date_serie_ptr get_date_serie(const myDate &date_begin, const myDate &date_end, const tenor_def &tenor);
+date_serie_ptr get_date_serie(const myDate &date_begin, const myDate &date_end, const tenor_def &tenor, const myCalendar &cal, const bday_conv &conv);
+void clear_date_serie_cache();
 double eval_freq(const std::string &freq);
+void match_dates(const std::vector<myDate> &dates, const std::vector<myDate> &target_dates, const date_match &rule, int * idxs);
 int get_nearest_idx(const myDate &date, const std::vector<myDate> &dates, const std::string &type);
@@ -0,0 +1,301 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+/*
+#include <iostream>
+#include <vector>
+#include "lib_interp.h"
+
+int main()
+{
+    // 1D interpolation with linear extrapolation; a hunting search reuses the previous segment, so sorted points are
+    // located in constant time
+    myGridInterp<double, 1, interp_extrap_linear, interp_search_hunt> interp1D({{{0, 1, 2, 3}}}, {0, 1, 3, 5});
+    std::vector<double> X = {-1, 0.5, 1.5, 2.5, 4};
+    std::vector<double> Y(X.size());
+    interp1D.eval({X.data()}, Y.data(), X.size());
+    for (int idx = 0; idx < X.size(); idx++)
+    {
+        std::cout << "Y(" << X[idx] << ") = " << Y[idx] << std::endl;
+    }
+
+    // 2D interpolation in single precision on tenor x strike grid; values are stored row by row, i.e. the last
+    // dimension is the fastest one
+    myGridInterp<float, 2> interp2D({{{365, 730, 1825}, {-0.01, 0.0, 0.01}}}, {0.010, 0.011, 0.012,
+                                                                              0.013, 0.014, 0.015,
+                                                                              0.016, 0.017, 0.018});
+    std::cout << "Z(1000, 0.005) = " << interp2D.eval({1000, 0.005}) << std::endl;
+
+    // 3D interpolation, e.g. expiry x swap tenor x strike cube
+    myGridInterp<double, 3> interp3D({{{1, 2}, {5, 10}, {0.0, 0.01}}}, {0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8});
+    std::cout << "W(1.5, 7.5, 0.005) = " << interp3D.eval({1.5, 7.5, 0.005}) << std::endl;
+
+    // the kernels work on plain arrays and can be evaluated at compile time
+    constexpr double x[] = {0, 1, 2};
+    static_assert(interp_search_binary::locate(x, 3, 1.5, -1) == 2, "segment is found at compile time");
+
+    // everything OK
+    return 0;
+}
+*/
+
+/*
+ * SEARCH POLICIES
+ */
+
+// index of the first knot within [first, last) that is not lower than X, or last if there is no such knot
+template <typename T>
+constexpr int interp_lower_bound(const T * x, int first, int last, const T &X)
+{
+    while (first < last)
+    {
+        int mid = first + (last - first) / 2;
+        if (x[mid] < X)
+        {
+            first = mid + 1;
+        }
+        else
+        {
+            last = mid;
+        }
+    }
+    return first;
+}
+
+// binary search; the hint is ignored
+struct interp_search_binary
+{
+    template <typename T>
+    static constexpr int locate(const T * x, const int &knots_no, const T &X, [[maybe_unused]] const int &hint)
+    {
+        return interp_lower_bound(x, 0, knots_no, X);
+    }
+};
+
+// hunting search; the search gallops away from the hint, i.e. the previously located knot, and finishes by binary
+// search, so nearby points are located in constant time and distant ones in logarithmic time; a negative hint
+// falls back to binary search
+struct interp_search_hunt
+{
+    template <typename T>
+    static constexpr int locate(const T * x, const int &knots_no, const T &X, const int &hint)
+    {
+        if ((hint < 0) || (hint >= knots_no))
+        {
+            return interp_lower_bound(x, 0, knots_no, X);
+        }
+
+        // hunt upwards
+        int step = 1;
+        if (x[hint] < X)
+        {
+            int lower = hint;
+            int upper = hint + 1;
+            while ((upper < knots_no) && (x[upper] < X))
+            {
+                lower = upper;
+                step *= 2;
+                upper = lower + step;
+            }
+            return interp_lower_bound(x, lower + 1, (upper < knots_no) ? upper : knots_no, X);
+        }
+
+        // hunt downwards
+        int upper = hint;
+        int lower = hint - 1;
+        while ((lower >= 0) && (x[lower] >= X))
+        {
+            upper = lower;
+            step *= 2;
+            lower = upper - step;
+        }
+        return interp_lower_bound(x, (lower >= 0) ? lower + 1 : 0, upper, X);
+    }
+};
+
+/*
+ * EXTRAPOLATION POLICIES
+ */
+
+// values are kept flat beyond the first and the last knot
+struct interp_extrap_flat
+{
+    static constexpr void below([[maybe_unused]] const int &knots_no, int &idx_lower, int &idx_upper)
+    {
+        idx_lower = 0;
+        idx_upper = 0;
+    }
+    static constexpr void above(const int &knots_no, int &idx_lower, int &idx_upper)
+    {
+        idx_lower = knots_no - 1;
+        idx_upper = knots_no - 1;
+    }
+};
+
+// values are extrapolated linearly from the first and the last segment
+struct interp_extrap_linear
+{
+    static constexpr void below(const int &knots_no, int &idx_lower, int &idx_upper)
+    {
+        idx_lower = 0;
+        idx_upper = (knots_no > 1) ? 1 : 0;
+    }
+    static constexpr void above(const int &knots_no, int &idx_lower, int &idx_upper)
+    {
+        idx_lower = (knots_no > 1) ? knots_no - 2 : 0;
+        idx_upper = knots_no - 1;
+    }
+};
+
+/*
+ * INTERPOLATION KERNELS
+ */
+
+// find indices of the surrounding knots of X; both indices are the same if X matches a knot; the hint is updated
+// with the located knot so that it can be passed to the search of the next point
+template <typename T, typename extrap_policy, typename search_policy>
+constexpr void interp_locate(const T * x, const int &knots_no, const T &X, int &idx_lower, int &idx_upper, int &hint)
+{
+    // X is out of the range defined through knots; NaN is treated as lying below the first knot
+    if (!(X > x[0]))
+    {
+        extrap_policy::below(knots_no, idx_lower, idx_upper);
+        hint = 0;
+        return;
+    }
+    else if (X >= x[knots_no - 1])
+    {
+        extrap_policy::above(knots_no, idx_lower, idx_upper);
+        hint = knots_no - 1;
+        return;
+    }
+
+    // X is within the range defined through knots
+    idx_upper = search_policy::locate(x, knots_no, X, hint);
+    idx_lower = (x[idx_upper] == X) ? idx_upper : idx_upper - 1;
+    hint = idx_upper;
+}
+
+// multilinear blend of the surrounding grid points starting from dimension dim; dimensions are interpolated from
+// the last one to the first one and no interpolation is done in dimensions where X matches a knot
+template <typename T, int D, int dim = 0>
+constexpr T interp_blend(const T * const * axes, const int * strides, const T * values, const int * idx_lower, const int * idx_upper, const T * X, const int &offset = 0)
+{
+    if constexpr (dim == D)
+    {
+        return values[offset];
+    }
+    else
+    {
+        T value_lower = interp_blend<T, D, dim + 1>(axes, strides, values, idx_lower, idx_upper, X, offset + idx_lower[dim] * strides[dim]);
+        if (idx_lower[dim] == idx_upper[dim])
+        {
+            return value_lower;
+        }
+        T value_upper = interp_blend<T, D, dim + 1>(axes, strides, values, idx_lower, idx_upper, X, offset + idx_upper[dim] * strides[dim]);
+        const T * x = axes[dim];
+        return value_lower + (value_upper - value_lower) / (x[idx_upper[dim]] - x[idx_lower[dim]]) * (X[dim] - x[idx_lower[dim]]);
+    }
+}
+
+/*
+ * INTERPOLATION OBJECT
+ */
+
+// define object that handles linear interpolation on a regular grid of compile-time dimension D; knots of each axis
+// are supposed to be in ascending order and values are stored row by row, i.e. the last dimension is the fastest
+// one; evaluation does not change the object, so one object can be shared by several threads
+template <typename T, int D, typename extrap_policy = interp_extrap_flat, typename search_policy = interp_search_binary>
+class myGridInterp
+{
+    static_assert(D >= 1, "Grid must have at least one dimension!");
+
+    private:
+        // variables
+        std::array<std::vector<T>, D> axes;
+        std::vector<T> values;
+        std::array<int, D> knots_nos;
+        std::array<int, D> strides;
+
+    public:
+        // object constructors
+        myGridInterp()
+        {
+            this->knots_nos.fill(0);
+            this->strides.fill(0);
+        }
+        myGridInterp(const std::array<std::vector<T>, D> &axes, const std::vector<T> &values)
+        {
+            // knots are supposed to be ordered in ascending order; the assumption is not checked
+            this->axes = axes;
+            this->values = values;
+
+            // calculate strides and check that there is one value for each grid point
+            int values_no = 1;
+            for (int dim = D - 1; dim >= 0; dim--)
+            {
+                if (this->axes[dim].size() == 0)
+                {
+                    throw std::invalid_argument((std::string)__func__ + ": At least one knot is required in each dimension!");
+                }
+                this->knots_nos[dim] = this->axes[dim].size();
+                this->strides[dim] = values_no;
+                values_no *= this->knots_nos[dim];
+            }
+            if (values_no != static_cast<int>(this->values.size()))
+            {
+                throw std::invalid_argument((std::string)__func__ + ": Number of values must be equal to the number of grid points!");
+            }
+        }
+
+        // object destructor
+        ~myGridInterp(){};
+
+        // object function declarations
+        const std::vector<T> &get_axis(const int &dim) const {return this->axes[dim];};
+        const std::vector<T> &get_values() const {return this->values;};
+
+        // interpolate a single point
+        T eval(const std::array<T, D> &X) const
+        {
+            const T * axes_ptrs[D];
+            int idx_lower[D];
+            int idx_upper[D];
+            for (int dim = 0; dim < D; dim++)
+            {
+                int hint = -1;
+                axes_ptrs[dim] = this->axes[dim].data();
+                interp_locate<T, extrap_policy, search_policy>(axes_ptrs[dim], this->knots_nos[dim], X[dim], idx_lower[dim], idx_upper[dim], hint);
+            }
+            return interp_blend<T, D>(axes_ptrs, this->strides.data(), this->values.data(), idx_lower, idx_upper, X.data());
+        }
+
+        // interpolate points whose co-ordinates in dimension dim are X[dim][0], ..., X[dim][values_no - 1] into
+        // caller-provided buffer; the located knots are passed as hints to the search of the next point
+        void eval(const std::array<const T *, D> &X, T * Y, const int &values_no) const
+        {
+            const T * axes_ptrs[D];
+            int hints[D];
+            for (int dim = 0; dim < D; dim++)
+            {
+                axes_ptrs[dim] = this->axes[dim].data();
+                hints[dim] = -1;
+            }
+            for (int idx = 0; idx < values_no; idx++)
+            {
+                T X_aux[D];
+                int idx_lower[D];
+                int idx_upper[D];
+                for (int dim = 0; dim < D; dim++)
+                {
+                    X_aux[dim] = X[dim][idx];
+                    interp_locate<T, extrap_policy, search_policy>(axes_ptrs[dim], this->knots_nos[dim], X_aux[dim], idx_lower[dim], idx_upper[dim], hints[dim]);
+                }
+                Y[idx] = interp_blend<T, D>(axes_ptrs, this->strides.data(), this->values.data(), idx_lower, idx_upper, X_aux);
+            }
+        }
+};
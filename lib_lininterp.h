@@ -16,10 +16,16 @@ int main()
     std::vector<double> y1 = {0, 1, 3, 5, 6, 7};
     std::vector<double> X1 = {-1, 1, 2, 8, 2.5, 1./3};
 
-    // create interpolation object and interpolate
+    // create interpolation object and interpolate; single points are found by binary search, arrays of points
+    // are walked with a forward cursor so that sorted points are interpolated in linear time
     myLinInterp interp(x1, y1);
     std::vector<double> Y1 = interp.eval(X1);
 
+    // interpolate into a caller-provided buffer without any allocation
+    double Y1_buffer[6];
+    interp.eval(X1.data(), Y1_buffer, X1.size());
+    std::cout << "Y(2.5) = " + std::to_string(interp.eval(2.5)) << std::endl;
+
     // print out results
     std::cout << "1D INTERPOLATION" << std::endl;
     for (int i = 0; i < Y1.size(); i++)
@@ -32,7 +38,8 @@ int main()
     // 2D linear interpolation
     //
 
-    // vectors x, y and z are supposed to be orderd in ascending order
+    // grid points may come in any order; y co-ordinates missing for some x are interpolated from the other y
+    // co-ordinates of the same x
     std::vector<double> x2 = {2.0, 2.0, 2.0, 2.0, 2.0,
                               3.0, 3.0, 3.0, 3.0, 3.0,
                               4.0, 4.0, 4.0, 4.0, 4.0}; // x - maturity in years
@@ -53,6 +60,11 @@ int main()
     myLinInterp2D interp2D(x2, y2, z2);
     std::vector<double> Z2 = interp2D.eval(X2, Y2);
 
+    // interpolate into a caller-provided buffer without any allocation
+    double Z2_buffer[4];
+    interp2D.eval(X2.data(), Y2.data(), Z2_buffer, X2.size());
+    std::cout << "Z(2.5, 0.5) = " + std::to_string(interp2D.eval(2.5, 0.5)) << std::endl;
+
     // print out results
     std::cout << "2D INTERPOLATION" << std::endl;
     for (int i = 0; i < Z2.size(); i++)
@@ -72,16 +84,16 @@ int main()
 #include <string>
 #include <tuple>
 #include <vector>
+#include "lib_interp.h"
 
-// define object that handles 1D linear interpolations
+// define object that handles 1D linear interpolations; values are kept flat beyond the first and the last knot;
+// evaluation does not change the object, so one object can be shared by several threads; it is a thin wrapper of
+// the header-only grid interpolation, so evaluation can be inlined at call sites
 class myLinInterp
 {
     private:
         // variables
-        std::vector<double> x;
-        std::vector<double> y;
-        std::vector<double> X;
-        std::vector<double> Y;
+        myGridInterp<double, 1, interp_extrap_flat, interp_search_hunt> interp;
 
     public:
         // object constructors
@@ -91,28 +103,29 @@ class myLinInterp
         ~myLinInterp(){};
 
         // object function declarations
-        std::vector<double> eval(const std::vector<double> &X);
+        double eval(const double &X) const {return this->interp.eval({X});};
+        void eval(const double * X, double * Y, const int &values_no) const {this->interp.eval({X}, Y, values_no);};
+        std::vector<double> eval(const std::vector<double> &X) const;
 };
 
-// define object that handles 2D linear interpolations
+// define object that handles 2D linear interpolations on a regular grid; unique x and y co-ordinates are detected
+// in constructor and z is stored as a dense matrix, so that evaluation is two binary searches and a bilinear blend;
+// values are kept flat beyond the grid and evaluation does not change the object
 class myLinInterp2D
 {
     private:
         // variables
-        std::vector<double> x;
-        std::vector<double> y;
-        std::vector<double> z;
-        std::vector<double> X;
-        std::vector<double> Y;
-        std::vector<double> Z;
+        myGridInterp<double, 2> interp;
 
     public:
         // object constructors
-        myLinInterp2D(const std::vector<double> &x, std::vector<double> &y, const std::vector<double> &z);
+        myLinInterp2D(const std::vector<double> &x, const std::vector<double> &y, const std::vector<double> &z);
 
         // object destructor
         ~myLinInterp2D(){};
 
         // object function declarations
-        std::vector<double> eval(const std::vector<double> &X, const std::vector<double> &Y);
+        double eval(const double &X, const double &Y) const {return this->interp.eval({X, Y});};
+        void eval(const double * X, const double * Y, double * Z, const int &values_no) const {this->interp.eval({X, Y}, Z, values_no);};
+        std::vector<double> eval(const std::vector<double> &X, const std::vector<double> &Y) const;
 };
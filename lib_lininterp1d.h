@@ -1,61 +1,35 @@
 #pragma once
 
-#include <iostream>
 #include <string>
 #include <vector>
+#include "lib_lininterp.h"
 
 /*
 #include <string>
 #include <iostream>
 #include "lib_lininterp1d.h"
 
-using namespace std;
-
 int main()
 {
-    // pointer to vector holding the interpolated figures
-    vector<double> * Y = new vector<double>();
-
     // x and y are supposed to be orderd in ascending order
-    vector<double> x = {0, 1, 2, 3, 4, 5}; 
-    vector<double> y = {0, 1, 3, 5, 6, 7};
-    vector<double> X = {-1, 1, 2, 8, 2.5, 1./3};
+    std::vector<double> x = {0, 1, 2, 3, 4, 5};
+    std::vector<double> y = {0, 1, 3, 5, 6, 7};
+    std::vector<double> X = {-1, 1, 2, 8, 2.5, 1./3};
 
     // create interpolation object and interpolate
     myLinInterp1d interp(x, y);
-    Y = interp.eval(X);
+    std::vector<double> Y = interp.eval(X);
 
     // print out results
-    for (int i = 0; i < Y->size(); i++)
+    for (int i = 0; i < Y.size(); i++)
     {
-        cout << "Y[" + to_string(i) + "] = " + to_string((*Y)[i]) << std::endl;
+        std::cout << "Y[" + std::to_string(i) + "] = " + std::to_string(Y[i]) << std::endl;
     }
 
-    // delete pointer
-    delete Y;
-
     // everything OK
     return 0;
 }
 */
 
-// define object that handles linear interpolations
-class myLinInterp1d
-{
-    private:
-        // variables
-        std::vector<double> x;
-        std::vector<double> y;
-        std::vector<double> X;
-        std::vector<double> Y;
-
-    public:
-        // object constructors
-        myLinInterp1d(const std::vector<double> &_x, const std::vector<double> &_y);
-
-        // object destructor
-        ~myLinInterp1d(){};
-
-        // object function declarations
-        std::vector<double> * eval(const std::vector<double> &_X);
-};
\ No newline at end of file
+// 1D linear interpolation has been folded into myLinInterp; the name is kept for backward compatibility
+typedef myLinInterp myLinInterp1d;
@@ -1,10 +1,38 @@
 #include <cmath>
+#include <string>
 #include <vector>
-#include <sstream>
 #include <iostream>
-#include <iomanip>
 #include <stdexcept>
 #include "lib_math.h"
+#include "lib_solver.h"
+
+/*
+ * TRANSCENDENTAL KERNELS
+ */
+
+void fast_exp(const double * x, double * y, const int &values_no)
+{
+    for (int idx = 0; idx < values_no; idx++)
+    {
+        y[idx] = fast_exp(x[idx]);
+    }
+}
+
+void fast_log(const double * x, double * y, const int &values_no)
+{
+    for (int idx = 0; idx < values_no; idx++)
+    {
+        y[idx] = fast_log(x[idx]);
+    }
+}
+
+void fast_pow(const double * x, const double * y, double * z, const int &values_no)
+{
+    for (int idx = 0; idx < values_no; idx++)
+    {
+        z[idx] = fast_pow(x[idx], y[idx]);
+    }
+}
 
 /*
  * NORMAL DISTRIBUTION
@@ -13,129 +41,206 @@
 // see: https://stackoverflow.com/questions/2328258/cumulative-normal-distribution-function-in-c-c
 std::vector<double> norm_cdf(const std::vector<double> &x)
 {
-    double M_SQRT_1_2 = std::sqrt(0.5);
-    std::vector<double> cdf;
+    std::vector<double> cdf(x.size());
     for (int idx = 0; idx < x.size(); idx++)
     {
-        cdf.push_back(0.5 * std::erfc(-x[idx] * M_SQRT_1_2));
+        cdf[idx] = norm_cdf(x[idx]);
     }
     return cdf;
 }
 
 std::vector<double> norm_pdf(const std::vector<double> &x)
 {
-    double PI = 3.14159265358979;
-    std::vector<double> pdf;
+    std::vector<double> pdf(x.size());
     for (int idx = 0; idx < x.size(); idx++)
     {
-        pdf.push_back(1 / std::sqrt(2 * PI) * std::exp(-0.5 * std::pow(x[idx], 2)));
+        pdf[idx] = norm_pdf(x[idx]);
     }
     return pdf;
 }
 
-// auxiliary function for norm_inv()
-double rational_approximation(double t)
+// exp(-x^2 / 2) with x^2 split into exactly representable part and a small remainder so that rounding error of x^2
+// is not magnified in tails of the distribution
+inline double norm_exp_aux(const double &x)
 {
-    // Abramowitz and Stegun formula 26.2.23.
-    // the absolute value of the error should be less than 4.5 e-4.
-    double c[] = {2.515517, 0.802853, 0.010328};
-    double d[] = {1.432788, 0.189269, 0.001308};
-    return t - ((c[2] * t + c[1]) * t + c[0]) / (((d[2] * t + d[1]) * t + d[0]) * t + 1.0);
+    const double shifter = 6755399441055744.0;
+    double x_hi = ((16 * x + shifter) - shifter) / 16;
+    return fast_exp(-0.5 * x_hi * x_hi) * fast_exp(-0.5 * (x - x_hi) * (x + x_hi));
 }
 
-// auxiliary function for norm_inv()
-double norm_inv_aux(double p)
+// tail probability is evaluated by Hart's rational approximation close to the mean (see: G. West, Better
+// approximations to cumulative normal functions, Wilmott Magazine, 2005) and by Laplace continued fraction of Mills
+// ratio in tails; both branches are evaluated and the result is selected so that the loop has no branches
+void norm_cdf(const double * x, double * cdf, const int &values_no)
 {
-    if (p <= 0.0 || p >= 1.0)
+    for (int idx = 0; idx < values_no; idx++)
     {
-        std::stringstream os;
-        os << "Invalid input argument (" << p << "); must be larger than 0 but less than 1.";
-        throw std::invalid_argument(os.str());
+        double x_abs = std::fabs(x[idx]);
+        double e = norm_exp_aux(x_abs);
+
+        // rational approximation
+        double num = 3.52624965998911e-02 * x_abs + 0.700383064443688;
+        num = num * x_abs + 6.37396220353165;
+        num = num * x_abs + 33.912866078383;
+        num = num * x_abs + 112.079291497871;
+        num = num * x_abs + 221.213596169931;
+        num = num * x_abs + 220.206867912376;
+        double den = 8.83883476483184e-02 * x_abs + 1.75566716318264;
+        den = den * x_abs + 16.064177579207;
+        den = den * x_abs + 86.7807322029461;
+        den = den * x_abs + 296.564248779674;
+        den = den * x_abs + 637.333633378831;
+        den = den * x_abs + 793.826512519948;
+        den = den * x_abs + 440.413735824752;
+        double tail_near = e * num / den;
+
+        // continued fraction x + 1 / (x + 2 / (x + 3 / ...)) is evaluated by forward recurrence of its
+        // numerators and denominators so that there is a single division; the terms are positive and do not cancel;
+        // the loop is unrolled so that the outer loop can be vectorized
+        double num_prev = 1.;
+        double num_curr = x_abs;
+        double den_prev = 0.;
+        double den_curr = 1.;
+        #pragma GCC unroll 24
+        for (int k = 1; k <= 24; k++)
+        {
+            double num_next = x_abs * num_curr + k * num_prev;
+            double den_next = x_abs * den_curr + k * den_prev;
+            num_prev = num_curr;
+            num_curr = num_next;
+            den_prev = den_curr;
+            den_curr = den_next;
+        }
+        double cf = num_curr / den_curr;
+        double tail_far = e / cf / 2.5066282746310002;
+
+        double tail = select_if_negative(x_abs - 4.5, tail_near, tail_far);
+        tail = select_if_negative(38.5 - x_abs, 0.0, tail);
+        cdf[idx] = select_if_negative(-x[idx], 1 - tail, tail);
     }
+}
 
-    if (p < 0.5)
+void norm_pdf(const double * x, double * pdf, const int &values_no)
+{
+    double PI = 3.14159265358979;
+    double norm_const = 1 / std::sqrt(2 * PI);
+    for (int idx = 0; idx < values_no; idx++)
     {
-        // F^-1(p) = - G^-1(p)
-        return -rational_approximation( sqrt(-2.0 * log(p)) );
+        pdf[idx] = norm_const * norm_exp_aux(x[idx]);
     }
-    else
+}
+
+// coefficients of Wichura's algorithm AS241 (PPND16); see: M. J. Wichura, Algorithm AS 241: The percentage points
+// of the normal distribution, Applied Statistics 37, 1988; numerators and denominators of rational approximations
+// are stored from the constant term upwards
+static const double norm_inv_a[8] = {3.3871328727963666080e+0, 1.3314166789178437745e+2, 1.9715909503065514427e+3, 1.3731693765509461125e+4,
+                                     4.5921953931549871457e+4, 6.7265770927008700853e+4, 3.3430575583588128105e+4, 2.5090809287301226727e+3};
+static const double norm_inv_b[8] = {1.0, 4.2313330701600911252e+1, 6.8718700749205790830e+2, 5.3941960214247511077e+3,
+                                     2.1213794301586595867e+4, 3.9307895800092710610e+4, 2.8729085735721942674e+4, 5.2264952788528545610e+3};
+static const double norm_inv_c[8] = {1.42343711074968357734e+0, 4.63033784615654529590e+0, 5.76949722146069140550e+0, 3.64784832476320460504e+0,
+                                     1.27045825245236838258e+0, 2.41780725177450611770e-1, 2.27238449892691845833e-2, 7.74545014278341407640e-4};
+static const double norm_inv_d[8] = {1.0, 2.05319162663775882187e+0, 1.67638483018380384940e+0, 6.89767334985100004550e-1,
+                                     1.48103976427480074590e-1, 1.51986665636164571966e-2, 5.47593808499534494600e-4, 1.05075007164441684324e-9};
+static const double norm_inv_e[8] = {6.65790464350110377720e+0, 5.46378491116411436990e+0, 1.78482653991729133580e+0, 2.96560571828504891230e-1,
+                                     2.65321895265761230930e-2, 1.24266094738807843860e-3, 2.71155556874348757815e-5, 2.01033439929228813265e-7};
+static const double norm_inv_f[8] = {1.0, 5.99832206555887937690e-1, 1.36929880922735805310e-1, 1.48753612908506148525e-2,
+                                     7.86869131145613259100e-4, 1.84631831751005468180e-5, 1.42151175831644588870e-7, 2.04426310338993978564e-15};
+
+// evaluate rational function of degree 7 in Horner form
+static inline double norm_inv_ratio(const double * num, const double * den, const double &r)
+{
+    double n = num[7];
+    double d = den[7];
+    for (int idx = 6; idx >= 0; idx--)
     {
-        // F^-1(p) = G^-1(1-p)
-        return rational_approximation( sqrt(-2.0 * log(1 - p)) );
+        n = n * r + num[idx];
+        d = d * r + den[idx];
     }
+    return n / d;
+}
+
+// inverse of standardized normal distribution in tails, i.e. for |p - 0.5| > 0.425; p = 0 and p = 1 give -inf and
+// inf, other arguments outside of interval (0, 1) give NaN
+static double norm_inv_tail(const double &p)
+{
+    if (p == 0.0 || p == 1.0)
+    {
+        return (p == 0.0) ? -HUGE_VAL : HUGE_VAL;
+    }
+    else if (!(p > 0.0 && p < 1.0))
+    {
+        return NAN;
+    }
+    double r = std::sqrt(-std::log((p < 0.5) ? p : 1 - p));
+    double x = (r <= 5.0) ? norm_inv_ratio(norm_inv_c, norm_inv_d, r - 1.6) : norm_inv_ratio(norm_inv_e, norm_inv_f, r - 5.0);
+    return (p < 0.5) ? -x : x;
+}
+
+// inverse of standardized normal distribution; relative error is about 1e-16 over the whole range
+double norm_inv(const double &p)
+{
+    if (!(p > 0.0 && p < 1.0))
+    {
+        throw std::invalid_argument((std::string)__func__ + ": Invalid input argument (" + std::to_string(p) + "); must be larger than 0 but less than 1!");
+    }
+
+    // central region
+    double q = p - 0.5;
+    if (std::fabs(q) <= 0.425)
+    {
+        return q * norm_inv_ratio(norm_inv_a, norm_inv_b, 0.180625 - q * q);
+    }
+
+    // tails
+    return norm_inv_tail(p);
 }
 
-// see: https://www.johndcook.com/blog/cpp_phi_inverse/
 std::vector<double> norm_inv(const std::vector<double> &x)
 {
-    std::vector<double> p;
+    std::vector<double> p(x.size());
     for (int idx = 0; idx < x.size(); idx++)
     {
-        p.push_back(norm_inv_aux(x[idx]));
+        p[idx] = norm_inv(x[idx]);
     }
     return p;
 }
 
+// the central region covers 85% of uniformly distributed arguments; it is evaluated for all arguments in a loop
+// without branches, which can be vectorized, and only the remaining arguments are then evaluated one by one
+void norm_inv(const double * p, double * x, const int &values_no)
+{
+    for (int idx = 0; idx < values_no; idx++)
+    {
+        double q = p[idx] - 0.5;
+        x[idx] = q * norm_inv_ratio(norm_inv_a, norm_inv_b, 0.180625 - q * q);
+    }
+    for (int idx = 0; idx < values_no; idx++)
+    {
+        if (!(std::fabs(p[idx] - 0.5) <= 0.425))
+        {
+            x[idx] = norm_inv_tail(p[idx]);
+        }
+    }
+}
+
 /*
  * NEWTON-RAPHSON METHOD
  */
+
+// kept for backward compatibility; see lib_solver.h for solvers accepting any callable and analytic derivatives
 newton_raphson_res newton_raphson(double (*func)(double), double x, const double &step, const double &tolerance, const int &iter_max)
 {
-    // variables
+    // solve with derivative by central difference
+    solver_res sol = newton(func, central_difference(func, step), x, tolerance, iter_max);
+
+    // fill in result structure
     newton_raphson_res res;
-    int iter_no = 0;
-    double derivative;
-    double x_down;
-    double x_up;
-    double func_down;
-    double func_par;
-    double func_up;
-
-    // initiate Newton-Raphson structure
-    res.x = x;
+    res.x = sol.x;
+    res.success = sol.success;
     res.step = step;
     res.tolerance = tolerance;
+    res.iter_no = sol.iter_no;
     res.iter_max = iter_max;
-
-    do
-    {
-        // calculate derivation at initinal point x
-        x_down = res.x - step;
-        x_up = res.x + step;
-        func_up = func(x_up);
-        func_down = func(x_down);
-        derivative = (func_up - func_down) / (2 * step);
-
-        // apply Newton-Raphson method
-        func_par = func(res.x);
-        if (derivative == 0.0)
-        {
-            // return result after derivation being equal to zero
-            res.success = false;
-            res.iter_no = iter_no;
-            res.msg = "zero derivation at point x = " + std::to_string(res.x);
-            return res;
-        }
-        else if (std::abs(func_par) < tolerance)
-        {
-            // return result after reaching proximity of zero
-            res.success = true;
-            res.iter_no = iter_no;
-            res.msg = "tolerance reached; f(x) = " + std::to_string(func_par);
-            return res;
-        }
-        else
-        {
-            // iterate
-            iter_no++;
-            res.x += -func_par / derivative;
-        }
-    } while (iter_no < iter_max);
-
-    // return result after exceeding maximum number of iterations
-    res.success = false;
-    res.iter_no = iter_no;
-    res.msg = "maxium number of iterations reached";
+    res.msg = sol.msg;
     return res;
-
-}
\ No newline at end of file
+}
@@ -33,6 +33,23 @@ int main()
     }
     std::cout << '\n' << std::endl;
 
+    // BATCH KERNELS; results are written into caller-provided buffers
+    double cdf_batch[9];
+    double pdf_batch[9];
+    norm_cdf(x.data(), cdf_batch, x.size());
+    norm_pdf(x.data(), pdf_batch, x.size());
+    std::cout << "scalar cdf: " << std::to_string(norm_cdf(1.0)) << ", batch cdf: " << std::to_string(cdf_batch[5]) << std::endl;
+
+    double z_batch[9];
+    norm_inv(q.data(), z_batch, q.size());
+    std::cout << "scalar inv: " << std::to_string(norm_inv(q[7])) << ", batch inv: " << std::to_string(z_batch[7]) << std::endl;
+
+    std::vector<double> base = {1.01, 1.02, 1.03};
+    std::vector<double> expnt = {0.5, 2.0, 10.0};
+    std::vector<double> pows(base.size());
+    fast_pow(base.data(), expnt.data(), pows.data(), base.size());
+    std::cout << "1.03^10: " << std::to_string(pows[2]) << '\n' << std::endl;
+
     // NEWTON-RAPHSON METHOD
     double X = 1.5;  // initial estimate of square root of 2
     double step = 1e-5;
@@ -58,14 +75,194 @@ int main()
 
 #pragma once
 
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
 
-// standardized normal distribution
+/*
+ * TRANSCENDENTAL KERNELS
+ */
+
+// the kernels are branch-free so that loops over arrays can be vectorized by the compiler; double type punning
+// is done through memcpy, which compiles into plain register moves; conditions are turned into bit masks derived
+// from sign bits as with conditional expressions the compiler branches around floating point operations of the
+// unused alternative, which prevents vectorization
+inline uint64_t double_to_bits(const double &x)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+inline double bits_to_double(const uint64_t &bits)
+{
+    double x;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+// return a if sign bit of cond is set and b otherwise
+inline double select_if_negative(const double &cond, const double &a, const double &b)
+{
+    uint64_t mask = 0 - (double_to_bits(cond) >> 63);
+    return bits_to_double((double_to_bits(a) & mask) | (double_to_bits(b) & ~mask));
+}
+
+// floor of |x| < 2^51; the argument is rounded to the nearest integer by adding and subtracting 1.5 * 2^52
+inline double fast_floor(const double &x)
+{
+    const double shifter = 6755399441055744.0;
+    double x_round = (x + shifter) - shifter;
+    return select_if_negative(0. - (x_round - x), x_round - 1, x_round); // 0. - ... keeps -0 from being floored to -1
+}
+
+// exponential function; x = k * ln(2) + r with |r| <= ln(2) / 2 and exp(r) is evaluated by Taylor polynomial of
+// degree 13 (truncation error below 5e-18); 2^k is applied in two halves so that subnormal results and results
+// close to overflow are handled as well; relative error is within 2 ulp (about 4.5e-16) over the whole range
+inline double fast_exp(const double &x)
+{
+    const double shifter = 6755399441055744.0; // 1.5 * 2^52; adding it rounds to integer kept in low mantissa bits
+    const uint64_t shifter_bits = 0x4338000000000000ULL;
+    const double log2e = 1.4426950408889634;
+    const double ln2_hi = 6.93147180369123816490e-01;
+    const double ln2_lo = 1.90821492927058770002e-10;
+
+    // range reduction
+    double k = (x * log2e + shifter) - shifter;
+    double r = (x - k * ln2_hi) - k * ln2_lo;
+
+    // Taylor polynomial in Horner form
+    double p = 1. / 6227020800.;
+    p = p * r + 1. / 479001600.;
+    p = p * r + 1. / 39916800.;
+    p = p * r + 1. / 3628800.;
+    p = p * r + 1. / 362880.;
+    p = p * r + 1. / 40320.;
+    p = p * r + 1. / 5040.;
+    p = p * r + 1. / 720.;
+    p = p * r + 1. / 120.;
+    p = p * r + 1. / 24.;
+    p = p * r + 1. / 6.;
+    p = p * r + 0.5;
+    p = p * r + 1.;
+    p = p * r + 1.;
+
+    // split 2^k into 2^k1 * 2^k2, both of them being normal numbers
+    double k1 = (0.5 * k + shifter) - shifter;
+    double k2 = k - k1;
+    double scale1 = bits_to_double((double_to_bits(k1 + shifter) - shifter_bits + 1023) << 52);
+    double scale2 = bits_to_double((double_to_bits(k2 + shifter) - shifter_bits + 1023) << 52);
+    uint64_t exp_bits = double_to_bits(p * scale1 * scale2);
+
+    // beyond these bounds the result is zero or infinity; NaN is propagated
+    uint64_t x_bits = double_to_bits(x);
+    uint64_t mask_nan = 0 - ((0x7ff0000000000000ULL - (x_bits & 0x7fffffffffffffffULL)) >> 63);
+    uint64_t mask_zero = (0 - (double_to_bits(x + 746.0) >> 63)) & ~mask_nan;
+    uint64_t mask_inf = (0 - (double_to_bits(710.0 - x) >> 63)) & ~mask_nan;
+    exp_bits = exp_bits & ~mask_zero;
+    exp_bits = (exp_bits & ~mask_inf) | (0x7ff0000000000000ULL & mask_inf);
+    return bits_to_double(exp_bits);
+}
+
+// natural logarithm; x = 2^e * m with m in [sqrt(1/2), sqrt(2)) and log(m) = 2 * atanh(s), s = (m - 1) / (m + 1),
+// is evaluated by series up to s^21 (|s| <= 0.172, truncation error below 1e-17); relative error is within 2 ulp
+// (about 4.5e-16) for positive arguments; log(0) = -inf, log(inf) = inf and negative arguments give NaN
+inline double fast_log(const double &x)
+{
+    const double two52 = 4503599627370496.0; // 2^52
+    const double ln2_hi = 6.93147180369123816490e-01;
+    const double ln2_lo = 1.90821492927058770002e-10;
+
+    // subnormal arguments are scaled into normal range by 2^54
+    double subnormal = x - 2.2250738585072014e-308;
+    double x_aux = x * select_if_negative(subnormal, 18014398509481984.0, 1.);
+
+    // split into exponent and mantissa
+    uint64_t bits = double_to_bits(x_aux);
+    double e = bits_to_double((bits >> 52) | 0x4330000000000000ULL) - two52 - 1023;
+    double m = bits_to_double((bits & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL);
+    double above = 1.4142135623730951 - m;
+    m = m * select_if_negative(above, 0.5, 1.);
+    e = e + select_if_negative(above, 1., 0.) - select_if_negative(subnormal, 54., 0.);
+
+    // series of 2 * atanh(s) in Horner form
+    double s = (m - 1) / (m + 1);
+    double s2 = s * s;
+    double p = 1. / 21.;
+    p = p * s2 + 1. / 19.;
+    p = p * s2 + 1. / 17.;
+    p = p * s2 + 1. / 15.;
+    p = p * s2 + 1. / 13.;
+    p = p * s2 + 1. / 11.;
+    p = p * s2 + 1. / 9.;
+    p = p * s2 + 1. / 7.;
+    p = p * s2 + 1. / 5.;
+    p = p * s2 + 1. / 3.;
+    uint64_t log_bits = double_to_bits(e * ln2_hi + (2 * s + (2 * s * s2 * p + e * ln2_lo)));
+
+    // special arguments; infinity and NaN are returned as they are
+    uint64_t x_bits = double_to_bits(x);
+    uint64_t x_abs_bits = x_bits & 0x7fffffffffffffffULL;
+    uint64_t mask_zero = 0 - ((x_abs_bits - 1) >> 63);
+    uint64_t mask_inf_nan = 0 - ((0x7fefffffffffffffULL - x_abs_bits) >> 63);
+    uint64_t mask_negative = (0 - (x_bits >> 63)) & ~mask_zero;
+    log_bits = (log_bits & ~mask_inf_nan) | (x_bits & mask_inf_nan);
+    log_bits = (log_bits & ~mask_zero) | (0xfff0000000000000ULL & mask_zero);
+    log_bits = (log_bits & ~mask_negative) | (0x7ff8000000000000ULL & mask_negative);
+    return bits_to_double(log_bits);
+}
+
+// power function for positive base evaluated as exp(y * log(x)); the error of log(x) is scaled by y, so the relative
+// error is within (2 + 2 * |y * log(x)|) ulp, i.e. below 5e-15 for |y * log(x)| <= 10 as with discounting over
+// decades; zero base gives zero for positive exponent and negative base gives NaN
+inline double fast_pow(const double &x, const double &y)
+{
+    return fast_exp(y * fast_log(x));
+}
+
+// batch kernels over caller-provided arrays of values_no elements; output may alias input
+void fast_exp(const double * x, double * y, const int &values_no);
+void fast_log(const double * x, double * y, const int &values_no);
+void fast_pow(const double * x, const double * y, double * z, const int &values_no);
+
+/*
+ * STANDARDIZED NORMAL DISTRIBUTION
+ */
+
+// scalar functions; they do not allocate and should be used instead of vectors with a single element
+inline double norm_cdf(const double &x)
+{
+    return 0.5 * std::erfc(-x * std::sqrt(0.5));
+}
+
+inline double norm_pdf(const double &x)
+{
+    double PI = 3.14159265358979;
+    return 1 / std::sqrt(2 * PI) * std::exp(-0.5 * x * x);
+}
+
+// inverse of standardized normal distribution by Wichura's algorithm AS241 with relative error about 1e-16; arguments
+// outside of interval (0, 1) raise an exception
+double norm_inv(const double &p);
+
+// vector functions
 std::vector<double> norm_cdf(const std::vector<double> &x);
 std::vector<double> norm_pdf(const std::vector<double> &x);
 std::vector<double> norm_inv(const std::vector<double> &x);
 
+// batch functions over caller-provided arrays of values_no elements; output may alias input; cdf is evaluated through
+// tail probability 0.5 * erfc(|x| / sqrt(2)) with absolute error below 3e-16 and relative error of the tail below
+// 1e-11 for |x| < 4.5 and below 2e-13 beyond; pdf has relative error below 1e-15
+void norm_cdf(const double * x, double * cdf, const int &values_no);
+void norm_pdf(const double * x, double * pdf, const int &values_no);
+
+// batch inverse of standardized normal distribution, e.g. to turn uniform (quasi-)random numbers into normal ones;
+// the accuracy is the same as of the scalar function; p = 0 and p = 1 give -inf and inf and other arguments outside
+// of interval (0, 1) give NaN rather than an exception; output must not alias input
+void norm_inv(const double * p, double * x, const int &values_no);
+
 // Newton-Raphson method
 struct newton_raphson_res
 {
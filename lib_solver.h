@@ -0,0 +1,340 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include "lib_math.h"
+
+/*
+#include <iostream>
+#include <vector>
+#include "lib_solver.h"
+
+int main()
+{
+    // any callable can be used, including lambdas capturing state
+    double a = 2.0;
+    auto func = [&a](const double &x) {return x * x - a;};
+    auto deriv = [](const double &x) {return 2 * x;};
+
+    // Newton method with analytic and numerical derivative
+    solver_res res1 = newton(func, deriv, 1.5, 1e-12, 100);
+    solver_res res2 = newton(func, central_difference(func, 1e-6), 1.5, 1e-12, 100);
+    std::cout << "Newton: " << res1.x << " after " << res1.iter_no << " iterations; " << res1.msg << std::endl;
+    std::cout << "Newton (numerical derivative): " << res2.x << "; " << res2.msg << std::endl;
+
+    // Newton method safeguarded by bisection and Brent method on a bracketing interval
+    solver_res res3 = newton_bisection(func, deriv, 0.0, 2.0, 1e-12, 100);
+    solver_res res4 = brent(func, 0.0, 2.0, 1e-12, 100);
+    std::cout << "Newton-bisection: " << res3.x << ", Brent: " << res4.x << std::endl;
+
+    // many independent equations x^2 - a_i = 0 solved in lockstep; values and derivatives of all equations are
+    // evaluated at once, which allows the compiler to vectorize the evaluation
+    std::vector<double> as = {2.0, 3.0, 5.0, 7.0};
+    std::vector<double> x(as.size(), 1.0);
+    std::vector<double> f(as.size());
+    std::vector<double> df(as.size());
+    auto fdf = [&as](const double * x, double * f, double * df, const int &values_no)
+    {
+        for (int idx = 0; idx < values_no; idx++)
+        {
+            f[idx] = x[idx] * x[idx] - as[idx];
+            df[idx] = 2 * x[idx];
+        }
+    };
+    int iter_no = newton_batch(fdf, x.data(), f.data(), df.data(), x.size(), 1e-12, 100);
+    for (int idx = 0; idx < x.size(); idx++)
+    {
+        std::cout << "sqrt(" << as[idx] << ") = " << x[idx] << std::endl;
+    }
+    std::cout << "iterations: " << iter_no << std::endl;
+
+    // everything OK
+    return 0;
+}
+*/
+
+// result of root finding; messages are string literals so that the result does not allocate
+struct solver_res
+{
+    double x; // root estimate
+    double f; // function value at root estimate
+    int iter_no; // number of iterations
+    bool success; // true if the tolerance was reached
+    const char * msg;
+};
+
+// numerical derivative by central difference; the function is captured by reference
+template <typename F>
+auto central_difference(const F &func, const double &step)
+{
+    return [&func, step](const double &x) {return (func(x + step) - func(x - step)) / (2 * step);};
+}
+
+// Newton method; iteration stops when |f(x)| < tolerance, when derivative is zero or after iter_max iterations
+template <typename F, typename D>
+solver_res newton(const F &func, const D &deriv, double x, const double &tolerance, const int &iter_max)
+{
+    solver_res res = {x, 0.0, 0, false, "maximum number of iterations reached"};
+    for (res.iter_no = 0; res.iter_no <= iter_max; res.iter_no++)
+    {
+        // check function value first so that the derivative is not evaluated at the root
+        res.f = func(res.x);
+        if (std::fabs(res.f) < tolerance)
+        {
+            res.success = true;
+            res.msg = "tolerance reached";
+            return res;
+        }
+        if (res.iter_no == iter_max)
+        {
+            break;
+        }
+
+        // apply Newton step
+        double df = deriv(res.x);
+        if (df == 0.0 || !std::isfinite(df))
+        {
+            res.msg = "zero derivative";
+            return res;
+        }
+        res.x -= res.f / df;
+    }
+    return res;
+}
+
+// Newton method safeguarded by bisection; root must be bracketed by x_low and x_high; a Newton step is replaced by
+// bisection whenever it leaves the bracket or does not halve the step before the last one, so the method converges
+// at least as fast as bisection
+template <typename F, typename D>
+solver_res newton_bisection(const F &func, const D &deriv, double x_low, double x_high, const double &tolerance, const int &iter_max)
+{
+    solver_res res = {x_low, 0.0, 0, false, "maximum number of iterations reached"};
+
+    // check bracket
+    double f_low = func(x_low);
+    double f_high = func(x_high);
+    if (std::fabs(f_low) < tolerance || std::fabs(f_high) < tolerance)
+    {
+        res.x = (std::fabs(f_low) < std::fabs(f_high)) ? x_low : x_high;
+        res.f = (std::fabs(f_low) < std::fabs(f_high)) ? f_low : f_high;
+        res.success = true;
+        res.msg = "tolerance reached";
+        return res;
+    }
+    if ((f_low > 0) == (f_high > 0))
+    {
+        res.msg = "root is not bracketed";
+        return res;
+    }
+
+    // orient bracket so that f(x_low) < 0
+    if (f_low > 0)
+    {
+        std::swap(x_low, x_high);
+    }
+
+    // start from the middle of the bracket
+    res.x = 0.5 * (x_low + x_high);
+    double dx_old = std::fabs(x_high - x_low);
+    double dx = dx_old;
+    for (res.iter_no = 0; res.iter_no < iter_max; res.iter_no++)
+    {
+        res.f = func(res.x);
+        if (std::fabs(res.f) < tolerance)
+        {
+            res.success = true;
+            res.msg = "tolerance reached";
+            return res;
+        }
+
+        // update bracket
+        if (res.f < 0)
+        {
+            x_low = res.x;
+        }
+        else
+        {
+            x_high = res.x;
+        }
+
+        // take Newton step if it stays within bracket and decreases fast enough, otherwise bisect
+        double df = deriv(res.x);
+        double x_newton = res.x - res.f / df;
+        bool inside = (x_newton - x_low) * (x_newton - x_high) < 0;
+        if (!inside || !(std::fabs(2 * res.f) <= std::fabs(dx_old * df)))
+        {
+            dx_old = dx;
+            dx = 0.5 * (x_high - x_low);
+            res.x = x_low + dx;
+        }
+        else
+        {
+            dx_old = dx;
+            dx = res.x - x_newton;
+            res.x = x_newton;
+        }
+
+        // bracket cannot be narrowed anymore
+        if (res.x == x_low || res.x == x_high)
+        {
+            res.f = func(res.x);
+            res.success = true;
+            res.msg = "bracket reached machine precision";
+            return res;
+        }
+    }
+    res.f = func(res.x);
+    return res;
+}
+
+// Brent method combining bisection, secant method and inverse quadratic interpolation; root must be bracketed by
+// x_low and x_high; iteration stops when |f(x)| < tolerance or when the bracket reaches machine precision
+template <typename F>
+solver_res brent(const F &func, const double &x_low, const double &x_high, const double &tolerance, const int &iter_max)
+{
+    const double eps = std::numeric_limits<double>::epsilon();
+    solver_res res = {x_high, 0.0, 0, false, "maximum number of iterations reached"};
+
+    // check bracket
+    double a = x_low;
+    double b = x_high;
+    double fa = func(a);
+    double fb = func(b);
+    if ((fa > 0 && fb > 0) || (fa < 0 && fb < 0))
+    {
+        res.f = fb;
+        res.msg = "root is not bracketed";
+        return res;
+    }
+
+    // b is the best estimate, a the previous one and c the counterpart of b in the bracket
+    double c = b;
+    double fc = fb;
+    double d = b - a;
+    double e = d;
+    for (res.iter_no = 0; res.iter_no <= iter_max; res.iter_no++)
+    {
+        // keep root between b and c
+        if ((fb > 0 && fc > 0) || (fb < 0 && fc < 0))
+        {
+            c = a;
+            fc = fa;
+            d = b - a;
+            e = d;
+        }
+        if (std::fabs(fc) < std::fabs(fb))
+        {
+            a = b;
+            b = c;
+            c = a;
+            fa = fb;
+            fb = fc;
+            fc = fa;
+        }
+
+        // check convergence
+        res.x = b;
+        res.f = fb;
+        double tol = 2 * eps * std::fabs(b) + std::numeric_limits<double>::min();
+        double m = 0.5 * (c - b);
+        if (std::fabs(fb) < tolerance || std::fabs(m) <= tol)
+        {
+            res.success = true;
+            res.msg = (std::fabs(fb) < tolerance) ? "tolerance reached" : "bracket reached machine precision";
+            return res;
+        }
+        if (res.iter_no == iter_max)
+        {
+            break;
+        }
+
+        // try interpolation, fall back to bisection
+        if (std::fabs(e) >= tol && std::fabs(fa) > std::fabs(fb))
+        {
+            double s = fb / fa;
+            double p;
+            double q;
+            if (a == c)
+            {
+                // secant method
+                p = 2 * m * s;
+                q = 1 - s;
+            }
+            else
+            {
+                // inverse quadratic interpolation
+                double r1 = fa / fc;
+                double r2 = fb / fc;
+                p = s * (2 * m * r1 * (r1 - r2) - (b - a) * (r2 - 1));
+                q = (r1 - 1) * (r2 - 1) * (s - 1);
+            }
+            if (p > 0)
+            {
+                q = -q;
+            }
+            else
+            {
+                p = -p;
+            }
+
+            // accept interpolation only if it falls within bracket and decreases fast enough
+            if (2 * p < std::min(3 * m * q - std::fabs(tol * q), std::fabs(e * q)))
+            {
+                e = d;
+                d = p / q;
+            }
+            else
+            {
+                d = m;
+                e = d;
+            }
+        }
+        else
+        {
+            d = m;
+            e = d;
+        }
+
+        // move to the new estimate
+        a = b;
+        fa = fb;
+        b += (std::fabs(d) > tol) ? d : ((m > 0) ? tol : -tol);
+        fb = func(b);
+    }
+    return res;
+}
+
+// Newton method for many independent equations in lockstep; fdf(x, f, df, values_no) evaluates function values and
+// derivatives of all equations at once into caller-provided buffers, which makes the evaluation vectorizable;
+// converged equations are kept in place, equations with zero derivative stop moving; on return f holds function
+// values at x, equations with |f| >= tolerance have not converged; the number of iterations is returned
+template <typename FDF>
+int newton_batch(const FDF &fdf, double * x, double * f, double * df, const int &values_no, const double &tolerance, const int &iter_max)
+{
+    int iter_no = 0;
+    while (true)
+    {
+        // evaluate all equations and count the ones that have not converged
+        fdf(x, f, df, values_no);
+        int active_no = 0;
+        for (int idx = 0; idx < values_no; idx++)
+        {
+            active_no += (std::fabs(f[idx]) < tolerance) ? 0 : 1;
+        }
+        if (active_no == 0 || iter_no == iter_max)
+        {
+            return iter_no;
+        }
+
+        // apply Newton step to all equations; the step is masked rather than branched around so that the loop
+        // can be vectorized
+        for (int idx = 0; idx < values_no; idx++)
+        {
+            double step = select_if_negative(0. - std::fabs(df[idx]), f[idx] / df[idx], 0.);
+            x[idx] -= select_if_negative(std::fabs(f[idx]) - tolerance, 0., step);
+        }
+        iter_no++;
+    }
+}